@@ -251,7 +251,10 @@ void BedItem::regeneratePlayer(Player* player) const
 				condition = NULL;
 			}
 			else
+			{
 				condition->setTicks(newRegenTicks);
+				player->invalidateConditionsCheck();
+			}
 		}
 		else
 			regen = sleptTime / 30;
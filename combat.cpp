@@ -28,11 +28,83 @@
 #include "tools.h"
 #include "weapons.h"
 #include "configmanager.h"
+#include "combatlog.h"
+#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+#include "protocolgame.h"
+#endif
 
 extern Game g_game;
 extern Weapons* g_weapons;
 extern ConfigManager g_config;
 
+#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+CombatPathStats Combat::pathStats[COMBAT_PATH_LAST];
+
+const char* Combat::getPathName(CombatPath_t path)
+{
+	switch(path)
+	{
+		case COMBAT_PATH_HEALTH_TARGET:
+			return "health (target)";
+		case COMBAT_PATH_HEALTH_AREA:
+			return "health (area)";
+		case COMBAT_PATH_MANA_TARGET:
+			return "mana (target)";
+		case COMBAT_PATH_MANA_AREA:
+			return "mana (area)";
+		case COMBAT_PATH_CONDITION_TARGET:
+			return "condition (target)";
+		case COMBAT_PATH_CONDITION_AREA:
+			return "condition (area)";
+		case COMBAT_PATH_DISPEL_TARGET:
+			return "dispel (target)";
+		case COMBAT_PATH_DISPEL_AREA:
+			return "dispel (area)";
+		case COMBAT_PATH_DEFAULT:
+			return "default";
+		default:
+			break;
+	}
+
+	return "unknown";
+}
+
+//adds the time and work spent until the end of the scope to a combat path
+class CombatPathTimer
+{
+	public:
+		CombatPathTimer(CombatPath_t _path)
+		{
+			path = _path;
+			spectatorQueries = Map::spectatorQueries;
+			luaCalls = LuaScriptInterface::callCount;
+			packets = ProtocolGame::packetsWritten;
+			start = boost::get_system_time();
+		}
+
+		~CombatPathTimer()
+		{
+			CombatPathStats& stats = Combat::pathStats[path];
+			stats.calls++;
+			stats.time += (boost::get_system_time() - start).total_microseconds();
+			stats.spectatorQueries += Map::spectatorQueries - spectatorQueries;
+			stats.luaCalls += LuaScriptInterface::callCount - luaCalls;
+			stats.packets += ProtocolGame::packetsWritten - packets;
+		}
+
+	private:
+		CombatPath_t path;
+		uint64_t spectatorQueries;
+		uint64_t luaCalls;
+		uint64_t packets;
+		boost::system_time start;
+};
+
+#define COMBAT_PATH_TIMER(path) CombatPathTimer combatPathTimer(path)
+#else
+#define COMBAT_PATH_TIMER(path)
+#endif
+
 Combat::Combat()
 {
 	params.valueCallback = NULL;
@@ -131,7 +203,7 @@ bool Combat::getMinMaxValues(Creature* creature, Creature* target, int32_t& min,
 }
 
 void Combat::getCombatArea(const Position& centerPos, const Position& targetPos, const AreaCombat* area,
-	std::list<Tile*>& list)
+	TileVector& list)
 {
 	if(area)
 		area->getList(centerPos, targetPos, list);
@@ -277,7 +349,7 @@ ReturnValue Combat::canTargetCreature(const Player* player, const Creature* targ
 
 ReturnValue Combat::canDoCombat(const Creature* caster, const Tile* tile, bool isAggressive)
 {
-	if(tile->hasProperty(BLOCKPROJECTILE))
+	if(tile->hasFlag(TILESTATE_BLOCKPROJECTILE))
 		return RET_NOTENOUGHROOM;
 
 	if(tile->floorChange())
@@ -756,7 +828,7 @@ void Combat::addDistanceEffect(Creature* caster, const Position& fromPos, const
 void Combat::CombatFunc(Creature* caster, const Position& pos,
 	const AreaCombat* area, const CombatParams& params, COMBATFUNC func, void* data)
 {
-	std::list<Tile*> tileList;
+	TileVector tileList;
 
 	if(caster)
 		getCombatArea(caster->getPosition(), pos, area, tileList);
@@ -769,7 +841,7 @@ void Combat::CombatFunc(Creature* caster, const Position& pos,
 	uint32_t diff;
 
 	//calculate the max viewable range
-	for(std::list<Tile*>::iterator it = tileList.begin(); it != tileList.end(); ++it)
+	for(TileVector::iterator it = tileList.begin(); it != tileList.end(); ++it)
 	{
 		const Position& tilePos = (*it)->getPosition();
 		diff = std::abs(tilePos.x - pos.x);
@@ -782,8 +854,9 @@ void Combat::CombatFunc(Creature* caster, const Position& pos,
 	}
 
 	g_game.getSpectators(list, pos, true, true, maxX + Map::maxViewportX, maxX + Map::maxViewportX, maxY + Map::maxViewportY, maxY + Map::maxViewportY);
+	CombatLogScope logScope(tileList.size(), list.size());
 
-	for(std::list<Tile*>::iterator it = tileList.begin(); it != tileList.end(); ++it)
+	for(TileVector::iterator it = tileList.begin(); it != tileList.end(); ++it)
 	{
 		Tile* iter_tile = *it;
 		bool bContinue = true;
@@ -858,6 +931,7 @@ void Combat::doCombat(Creature* caster, const Position& pos) const
 void Combat::doCombatHealth(Creature* caster, Creature* target,
 	int32_t minChange, int32_t maxChange, const CombatParams& params)
 {
+	COMBAT_PATH_TIMER(COMBAT_PATH_HEALTH_TARGET);
 	if(!params.isAggressive || (caster != target && Combat::canDoCombat(caster, target) == RET_NOERROR))
 	{
 		Combat2Var var;
@@ -874,6 +948,7 @@ void Combat::doCombatHealth(Creature* caster, Creature* target,
 void Combat::doCombatHealth(Creature* caster, const Position& pos,
 	const AreaCombat* area, int32_t minChange, int32_t maxChange, const CombatParams& params)
 {
+	COMBAT_PATH_TIMER(COMBAT_PATH_HEALTH_AREA);
 	Combat2Var var;
 	var.change = random_range(minChange, maxChange, DISTRO_NORMAL);
 	CombatFunc(caster, pos, area, params, CombatHealthFunc, (void*)&var);
@@ -882,6 +957,7 @@ void Combat::doCombatHealth(Creature* caster, const Position& pos,
 void Combat::doCombatMana(Creature* caster, Creature* target,
 	int32_t minChange, int32_t maxChange, const CombatParams& params)
 {
+	COMBAT_PATH_TIMER(COMBAT_PATH_MANA_TARGET);
 	if(!params.isAggressive || (caster != target && Combat::canDoCombat(caster, target) == RET_NOERROR))
 	{
 		Combat2Var var;
@@ -902,6 +978,7 @@ void Combat::doCombatMana(Creature* caster, Creature* target,
 void Combat::doCombatMana(Creature* caster, const Position& pos,
 	const AreaCombat* area, int32_t minChange, int32_t maxChange, const CombatParams& params)
 {
+	COMBAT_PATH_TIMER(COMBAT_PATH_MANA_AREA);
 	Combat2Var var;
 	var.change = random_range(minChange, maxChange, DISTRO_NORMAL);
 	CombatFunc(caster, pos, area, params, CombatManaFunc, (void*)&var);
@@ -910,11 +987,13 @@ void Combat::doCombatMana(Creature* caster, const Position& pos,
 void Combat::doCombatCondition(Creature* caster, const Position& pos, const AreaCombat* area,
 	const CombatParams& params)
 {
+	COMBAT_PATH_TIMER(COMBAT_PATH_CONDITION_AREA);
 	CombatFunc(caster, pos, area, params, CombatConditionFunc, NULL);
 }
 
 void Combat::doCombatCondition(Creature* caster, Creature* target, const CombatParams& params)
 {
+	COMBAT_PATH_TIMER(COMBAT_PATH_CONDITION_TARGET);
 	if(!params.isAggressive || (caster != target && Combat::canDoCombat(caster, target) == RET_NOERROR))
 	{
 		CombatConditionFunc(caster, target, params, NULL);
@@ -932,11 +1011,13 @@ void Combat::doCombatCondition(Creature* caster, Creature* target, const CombatP
 void Combat::doCombatDispel(Creature* caster, const Position& pos, const AreaCombat* area,
 	const CombatParams& params)
 {
+	COMBAT_PATH_TIMER(COMBAT_PATH_DISPEL_AREA);
 	CombatFunc(caster, pos, area, params, CombatDispelFunc, NULL);
 }
 
 void Combat::doCombatDispel(Creature* caster, Creature* target, const CombatParams& params)
 {
+	COMBAT_PATH_TIMER(COMBAT_PATH_DISPEL_TARGET);
 	if(!params.isAggressive || (caster != target && Combat::canDoCombat(caster, target) == RET_NOERROR))
 	{
 		CombatDispelFunc(caster, target, params, NULL);
@@ -953,6 +1034,7 @@ void Combat::doCombatDispel(Creature* caster, Creature* target, const CombatPara
 
 void Combat::doCombatDefault(Creature* caster, Creature* target, const CombatParams& params)
 {
+	COMBAT_PATH_TIMER(COMBAT_PATH_DEFAULT);
 	if(!params.isAggressive || (caster != target && Combat::canDoCombat(caster, target) == RET_NOERROR))
 	{
 		SpectatorVec list;
@@ -1035,6 +1117,10 @@ void ValueCallback::getMinMaxValues(Player* player, int32_t& min, int32_t& max,
 			}
 		}
 
+		#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+		LuaScriptInterface::callCount++;
+		#endif
+
 		int32_t size0 = lua_gettop(L);
 		if(lua_pcall(L, parameters, 2 /*nReturnValues*/, 0) != 0)
 			LuaScriptInterface::reportError(NULL, LuaScriptInterface::popString(L));
@@ -1113,6 +1199,10 @@ void TargetCallback::onTargetCombat(Creature* creature, Creature* target) const
 		lua_pushnumber(L, cid);
 		lua_pushnumber(L, targetCid);
 
+		#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+		LuaScriptInterface::callCount++;
+		#endif
+
 		int32_t size0 = lua_gettop(L);
 		if(lua_pcall(L, 2, 0 /*nReturnValues*/, 0) != 0)
 			LuaScriptInterface::reportError(NULL, LuaScriptInterface::popString(L));
@@ -1146,53 +1236,34 @@ AreaCombat::AreaCombat(const AreaCombat& rhs)
 		areas[it->first] = new MatrixArea(*it->second);
 }
 
-bool AreaCombat::getList(const Position& centerPos, const Position& targetPos, std::list<Tile*>& list) const
+bool AreaCombat::getList(const Position& centerPos, const Position& targetPos, TileVector& list) const
 {
-	Tile* tile = g_game.getTile(targetPos.x, targetPos.y, targetPos.z);
-
 	const MatrixArea* area = getArea(centerPos, targetPos);
 	if(!area)
 		return false;
 
-	int32_t tmpPosX = targetPos.x;
-	int32_t tmpPosY = targetPos.y;
-	int32_t tmpPosZ = targetPos.z;
-
-	size_t cols = area->getCols();
-	size_t rows = area->getRows();
-
-	uint32_t centerY, centerX;
-	area->getCenter(centerY, centerX);
-
-	tmpPosX -= centerX;
-	tmpPosY -= centerY;
-
-	for(size_t y = 0; y < rows; ++y)
+	const MatrixArea::OffsetList& offsets = area->getOffsets();
+	list.reserve(list.size() + offsets.size());
+	for(MatrixArea::OffsetList::const_iterator it = offsets.begin(); it != offsets.end(); ++it)
 	{
-		for(size_t x = 0; x < cols; ++x)
+		int32_t tmpPosX = targetPos.x + it->first;
+		int32_t tmpPosY = targetPos.y + it->second;
+		int32_t tmpPosZ = targetPos.z;
+		if(tmpPosX >= 0 && tmpPosX < 0xFFFF &&
+			tmpPosY >= 0 && tmpPosY < 0xFFFF &&
+			tmpPosZ >= 0 && tmpPosZ < MAP_MAX_LAYERS)
 		{
-			if(area->getValue(y, x) != 0)
+			if(g_game.isSightClear(targetPos, Position(tmpPosX, tmpPosY, tmpPosZ), true))
 			{
-				if(tmpPosX >= 0 && tmpPosX < 0xFFFF &&
-					tmpPosY >= 0 && tmpPosY < 0xFFFF &&
-					tmpPosZ >= 0 && tmpPosZ < MAP_MAX_LAYERS)
+				Tile* tile = g_game.getTile(tmpPosX, tmpPosY, tmpPosZ);
+				if(!tile)
 				{
-					if(g_game.isSightClear(targetPos, Position(tmpPosX, tmpPosY, tmpPosZ), true))
-					{
-						tile = g_game.getTile(tmpPosX, tmpPosY, tmpPosZ);
-						if(!tile)
-						{
-							tile = new StaticTile(tmpPosX, tmpPosY, tmpPosZ);
-							g_game.setTile(tile);
-						}
-						list.push_back(tile);
-					}
+					tile = new StaticTile(tmpPosX, tmpPosY, tmpPosZ);
+					g_game.setTile(tile);
 				}
+				list.push_back(tile);
 			}
-			tmpPosX++;
 		}
-		tmpPosX -= cols;
-		tmpPosY++;
 	}
 	return true;
 }
@@ -1292,6 +1363,8 @@ void AreaCombat::copyArea(const MatrixArea* input, MatrixArea* output, MatrixOpe
 		}
 		output->setCenter(rotateCenterY, rotateCenterX);
 	}
+
+	output->updateOffsets();
 }
 
 MatrixArea* AreaCombat::createArea(const std::list<uint32_t>& list, uint32_t rows)
@@ -1319,6 +1392,7 @@ MatrixArea* AreaCombat::createArea(const std::list<uint32_t>& list, uint32_t row
 		}
 	}
 
+	area->updateOffsets();
 	return area;
 }
 
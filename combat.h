@@ -109,6 +109,8 @@ struct Combat2Var
 	int32_t change;
 };
 
+typedef std::vector<Tile*> TileVector;
+
 class MatrixArea
 {
 	public:
@@ -120,14 +122,9 @@ class MatrixArea
 			rows = _rows;
 			cols = _cols;
 
-			data_ = new bool*[rows];
-
-			for(uint32_t row = 0; row < rows; ++row)
-			{
-				data_[row] = new bool[cols];
-				for(uint32_t col = 0; col < cols; ++col)
-					data_[row][col] = 0;
-			}
+			data_ = new bool[rows * cols];
+			for(uint32_t i = 0; i < rows * cols; ++i)
+				data_[i] = 0;
 		}
 
 		MatrixArea(const MatrixArea& rhs)
@@ -137,26 +134,20 @@ class MatrixArea
 			rows = rhs.rows;
 			cols = rhs.cols;
 
-			data_ = new bool*[rows];
-
-			for(uint32_t row = 0; row < rows; ++row)
-			{
-				data_[row] = new bool[cols];
+			data_ = new bool[rows * cols];
+			for(uint32_t i = 0; i < rows * cols; ++i)
+				data_[i] = rhs.data_[i];
 
-				for(uint32_t col = 0; col < cols; ++col)
-					data_[row][col] = rhs.data_[row][col];
-			}
+			offsets = rhs.offsets;
 		}
 
 		~MatrixArea()
 		{
-			for(uint32_t row = 0; row < rows; ++row)
-				delete[] data_[row];
 			delete[] data_;
 		}
 
-		void setValue(uint32_t row, uint32_t col, bool value) const {data_[row][col] = value;}
-		bool getValue(uint32_t row, uint32_t col) const {return data_[row][col];}
+		void setValue(uint32_t row, uint32_t col, bool value) const {data_[row * cols + col] = value;}
+		bool getValue(uint32_t row, uint32_t col) const {return data_[row * cols + col];}
 
 		void setCenter(uint32_t y, uint32_t x) {centerX = x; centerY = y;}
 		void getCenter(uint32_t& y, uint32_t& x) const {x = centerX; y = centerY;}
@@ -164,8 +155,24 @@ class MatrixArea
 		size_t getRows() const {return rows;}
 		size_t getCols() const {return cols;}
 
-		inline const bool* operator[](uint32_t i) const { return data_[i]; }
-		inline bool* operator[](uint32_t i) { return data_[i]; }
+		//set cells relative to the center in row order, refreshed once the area is filled
+		typedef std::vector<std::pair<int32_t, int32_t> > OffsetList;
+		void updateOffsets()
+		{
+			offsets.clear();
+			for(uint32_t y = 0; y < rows; ++y)
+			{
+				for(uint32_t x = 0; x < cols; ++x)
+				{
+					if(data_[y * cols + x])
+						offsets.push_back(std::make_pair((int32_t)x - (int32_t)centerX, (int32_t)y - (int32_t)centerY));
+				}
+			}
+		}
+		const OffsetList& getOffsets() const {return offsets;}
+
+		inline const bool* operator[](uint32_t i) const { return data_ + i * cols; }
+		inline bool* operator[](uint32_t i) { return data_ + i * cols; }
 
 	protected:
 		uint32_t centerX;
@@ -173,7 +180,8 @@ class MatrixArea
 
 		uint32_t rows;
 		uint32_t cols;
-		bool** data_;
+		bool* data_;
+		OffsetList offsets;
 };
 
 typedef std::map<Direction, MatrixArea* > AreaCombatMap;
@@ -187,7 +195,7 @@ class AreaCombat
 		AreaCombat(const AreaCombat& rhs);
 
 		ReturnValue doCombat(Creature* attacker, const Position& pos, const Combat& combat) const;
-		bool getList(const Position& centerPos, const Position& targetPos, std::list<Tile*>& list) const;
+		bool getList(const Position& centerPos, const Position& targetPos, TileVector& list) const;
 
 		void setupArea(const std::list<uint32_t>& list, uint32_t rows);
 		void setupArea(int32_t length, int32_t spread);
@@ -247,6 +255,34 @@ class AreaCombat
 		bool hasExtArea;
 };
 
+#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+enum CombatPath_t
+{
+	COMBAT_PATH_HEALTH_TARGET = 0,
+	COMBAT_PATH_HEALTH_AREA,
+	COMBAT_PATH_MANA_TARGET,
+	COMBAT_PATH_MANA_AREA,
+	COMBAT_PATH_CONDITION_TARGET,
+	COMBAT_PATH_CONDITION_AREA,
+	COMBAT_PATH_DISPEL_TARGET,
+	COMBAT_PATH_DISPEL_AREA,
+	COMBAT_PATH_DEFAULT,
+	COMBAT_PATH_LAST
+};
+
+//totals include any combat started from inside the path (e.g. by a Lua callback)
+struct CombatPathStats
+{
+	CombatPathStats() : calls(0), time(0), spectatorQueries(0), luaCalls(0), packets(0) {}
+
+	uint64_t calls;
+	uint64_t time; //microseconds
+	uint64_t spectatorQueries;
+	uint64_t luaCalls;
+	uint64_t packets;
+};
+#endif
+
 class Combat
 {
 	public:
@@ -274,7 +310,7 @@ class Combat
 			const AreaCombat* area, const CombatParams& params);
 
 		static void getCombatArea(const Position& centerPos, const Position& targetPos,
-			const AreaCombat* area, std::list<Tile*>& list);
+			const AreaCombat* area, TileVector& list);
 
 		static bool isInPvpZone(const Creature* attacker, const Creature* target);
 		static bool isProtected(const Player* attacker, const Player* target);
@@ -305,6 +341,11 @@ class Combat
 		void setPlayerCombatValues(formulaType_t _type, double _mina, double _minb, double _maxa, double _maxb);
 		void postCombatEffects(Creature* caster, const Position& pos) const {Combat::postCombatEffects(caster, pos, params);}
 
+#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+		static CombatPathStats pathStats[COMBAT_PATH_LAST];
+		static const char* getPathName(CombatPath_t path);
+#endif
+
 	protected:
 		static void doCombatDefault(Creature* caster, Creature* target, const CombatParams& params);
 
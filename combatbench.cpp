@@ -0,0 +1,836 @@
+//////////////////////////////////////////////////////////////////////
+// OpenTibia - an opensource roleplaying game
+//////////////////////////////////////////////////////////////////////
+// Combat benchmark - replays scripted fights on a synthetic arena
+//////////////////////////////////////////////////////////////////////
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//////////////////////////////////////////////////////////////////////
+
+#include "otpch.h"
+
+#ifdef __COMBAT_BENCH__
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <stdlib.h>
+
+#include "combatbench.h"
+#include "combat.h"
+#include "combatlog.h"
+#include "configmanager.h"
+#include "game.h"
+#include "player.h"
+#include "monster.h"
+#include "monsters.h"
+#include "luascript.h"
+#include "protocolgame.h"
+#include "spells.h"
+#include "talkaction.h"
+#include "tools.h"
+
+extern Game g_game;
+extern ConfigManager g_config;
+extern Spells* g_spells;
+extern TalkActions* g_talkActions;
+
+int64_t g_benchTime = 0;
+
+//a mix of passive conditions (exhausts, cooldowns, buffs) and conditions with periodic work
+static const struct
+{
+	ConditionType_t type;
+	int32_t param;
+} benchConditionTypes[] =
+{
+	{CONDITION_HASTE, 100},
+	{CONDITION_LIGHT, 6 | (215 << 8)},
+	{CONDITION_REGENERATION, 0},
+	{CONDITION_SOUL, 0},
+	{CONDITION_INFIGHT, 0},
+	{CONDITION_EXHAUST_WEAPON, 0},
+	{CONDITION_EXHAUST_COMBAT, 0},
+	{CONDITION_EXHAUST_HEAL, 0},
+	{CONDITION_MUTED, 0},
+	{CONDITION_PACIFIED, 0},
+	{CONDITION_ATTRIBUTES, 0},
+	{CONDITION_MANASHIELD, 0}
+};
+
+bool CombatBench::parseArguments(int argc, char* argv[], CombatBenchConfig& config)
+{
+	bool enabled = false;
+	for(int32_t i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if(arg == "--combat-bench")
+		{
+			enabled = true;
+			continue;
+		}
+
+		std::string::size_type pos = arg.find('=');
+		if(arg.compare(0, 8, "--bench-") != 0 || pos == std::string::npos)
+		{
+			std::cout << "> WARNING: Unknown argument " << arg << "." << std::endl;
+			continue;
+		}
+
+		std::string key = arg.substr(8, pos - 8), value = arg.substr(pos + 1);
+		if(key == "players")
+			config.players = atoi(value.c_str());
+		else if(key == "monsters")
+			config.monsters = atoi(value.c_str());
+		else if(key == "ticks")
+			config.ticks = atoi(value.c_str());
+		else if(key == "seed")
+			config.seed = atoi(value.c_str());
+		else if(key == "width")
+			config.width = std::max(1, atoi(value.c_str()));
+		else if(key == "ground")
+			config.groundId = atoi(value.c_str());
+		else if(key == "vocation")
+			config.vocation = atoi(value.c_str());
+		else if(key == "level")
+			config.level = std::max(1, atoi(value.c_str()));
+		else if(key == "maglevel")
+			config.magicLevel = atoi(value.c_str());
+		else if(key == "spellinterval")
+			config.spellInterval = atoi(value.c_str());
+		else if(key == "casters")
+			config.casters = atoi(value.c_str());
+		else if(key == "monsterrows")
+			config.monsterRows = std::max(1, atoi(value.c_str()));
+		else if(key == "conditions")
+		{
+			//either a count or a range like 5-10
+			std::string::size_type dash = value.find('-');
+			config.minConditions = atoi(value.substr(0, dash).c_str());
+			if(dash != std::string::npos)
+				config.maxConditions = atoi(value.substr(dash + 1).c_str());
+			else
+				config.maxConditions = config.minConditions;
+		}
+		else if(key == "sight" || key == "walk")
+		{
+			//x,y,z,radius
+			StringVec params = explodeString(value, ",");
+			if(params.size() == 4)
+			{
+				Position center(atoi(params[0].c_str()), atoi(params[1].c_str()), atoi(params[2].c_str()));
+				int32_t radius = std::max(0, atoi(params[3].c_str()));
+				if(key == "sight")
+				{
+					config.sightCenter = center;
+					config.sightRadius = radius;
+				}
+				else
+				{
+					config.walkCenter = center;
+					config.walkRadius = radius;
+				}
+			}
+			else
+				std::cout << "> WARNING: --bench-" << key << " expects x,y,z,radius." << std::endl;
+		}
+		else if(key == "chat")
+			config.chatFile = value;
+		else if(key == "armor")
+			config.armorRounds = atoi(value.c_str());
+		else if(key == "monster")
+			config.monsterName = value;
+		else if(key == "spells")
+			config.spells = value;
+		else
+			std::cout << "> WARNING: Unknown combat benchmark option " << key << "." << std::endl;
+	}
+
+	return enabled;
+}
+
+bool CombatBench::run(const CombatBenchConfig& _config)
+{
+	config = _config;
+	if(config.sightRadius > 0)
+		return checkSightLines();
+
+	if(config.walkRadius > 0)
+		return checkWalkSteps();
+
+	if(!config.chatFile.empty())
+		return checkChat();
+
+	spellWords = explodeString(config.spells, ";");
+	for(StringVec::iterator it = spellWords.begin(); it != spellWords.end();)
+	{
+		if(trimString(*it).empty())
+			it = spellWords.erase(it);
+		else
+			++it;
+	}
+
+	//same seed and same game time steps give the same rolls, also for math.random in scripts
+	srand(config.seed);
+	Monsters::seedLootRandom(config.seed);
+	g_benchTime = OTSYS_TIME();
+
+	std::cout << ">> Creating combat arena" << std::endl;
+	if(!createArena())
+		return false;
+
+	g_game.setGameState(GAME_STATE_NORMAL);
+	for(uint32_t i = 0; i < config.players; ++i)
+	{
+		if(!addPlayer(i))
+			return false;
+
+		addConditions(i);
+	}
+
+	renewConditions();
+	if(config.armorRounds > 0)
+		return checkArmor();
+
+	monsters.resize(config.monsters, NULL);
+	for(uint32_t i = 0; i < config.monsters; ++i)
+	{
+		if(!addMonster(i))
+			return false;
+	}
+
+	std::cout << ">> Running " << config.ticks << " ticks with " << config.players << " players and "
+		<< config.monsters << " " << config.monsterName << std::endl;
+	if(!conditions.empty())
+		std::cout << ">> Players carry " << conditions.size() << " conditions" << std::endl;
+
+	//setup is not part of the measurement
+	resetCounters();
+	monstersKilled = conditionsRenewed = 0;
+
+	boost::system_time start = boost::get_system_time();
+	for(uint32_t tick = 0; tick < config.ticks; ++tick)
+	{
+		g_benchTime += EVENT_CHECK_CREATURE_INTERVAL;
+		replaceDeadMonsters();
+		renewConditions();
+		updatePlayers(tick);
+		g_game.checkCreatureBucket();
+	}
+
+	printResults((boost::get_system_time() - start).total_microseconds());
+	return true;
+}
+
+bool CombatBench::loadMap()
+{
+	std::cout << ">> Loading map" << std::endl;
+	if(!g_game.loadMap(g_config.getString(ConfigManager::MAP_NAME)))
+	{
+		std::cout << "> ERROR: Failed to load map." << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+//the ground and item scan Tile::hasProperty did before the tile flags answered it
+static bool hasItemProperty(const Tile* tile, enum ITEMPROPERTY prop)
+{
+	if(tile->ground && tile->ground->hasProperty(prop))
+		return true;
+
+	if(const TileItemVector* items = tile->getItemList())
+	{
+		for(ItemVector::const_iterator it = items->begin(); it != items->end(); ++it)
+		{
+			if((*it)->hasProperty(prop))
+				return true;
+		}
+	}
+	return false;
+}
+
+bool CombatBench::checkWalkSteps()
+{
+	if(!loadMap())
+		return false;
+
+	Monster* monster = Monster::createMonster(config.monsterName);
+	if(!monster)
+	{
+		std::cout << "> ERROR: Unknown monster " << config.monsterName << "." << std::endl;
+		return false;
+	}
+
+	std::vector<const Tile*> tiles;
+	const Position& center = config.walkCenter;
+	for(int32_t x = std::max(0, center.x - config.walkRadius); x <= center.x + config.walkRadius; ++x)
+	{
+		for(int32_t y = std::max(0, center.y - config.walkRadius); y <= center.y + config.walkRadius; ++y)
+		{
+			if(const Tile* tile = g_game.getMap()->getTile(x, y, center.z))
+				tiles.push_back(tile);
+		}
+	}
+
+	static const ITEMPROPERTY props[] = {BLOCKSOLID, BLOCKPROJECTILE, BLOCKPATH, IMMOVABLEBLOCKSOLID,
+		IMMOVABLEBLOCKPATH, IMMOVABLENOFIELDBLOCKPATH, NOFIELDBLOCKPATH};
+	const uint32_t propCount = sizeof(props) / sizeof(props[0]);
+
+	uint32_t mismatches = 0;
+	std::vector<Position> walkable;
+	for(std::vector<const Tile*>::const_iterator it = tiles.begin(); it != tiles.end(); ++it)
+	{
+		if((*it)->__queryAdd(0, monster, 1, FLAG_PATHFINDING) == RET_NOERROR)
+			walkable.push_back((*it)->getPosition());
+
+		for(uint32_t i = 0; i < propCount; ++i)
+		{
+			if((*it)->hasProperty(props[i]) != hasItemProperty(*it, props[i]) && ++mismatches <= 10)
+				std::cout << "> Mismatch at " << (*it)->getPosition() << " for property " << props[i] << "." << std::endl;
+		}
+	}
+
+	std::cout << ">> Timing " << COMBAT_BENCH_WALK_PASSES << " passes over " << tiles.size() << " tiles around " << center << std::endl;
+	uint32_t results = 0;
+	boost::system_time start = boost::get_system_time();
+	for(uint32_t pass = 0; pass < COMBAT_BENCH_WALK_PASSES; ++pass)
+	{
+		for(std::vector<const Tile*>::const_iterator it = tiles.begin(); it != tiles.end(); ++it)
+			results += ((*it)->__queryAdd(0, monster, 1, FLAG_PATHFINDING) == RET_NOERROR);
+	}
+
+	uint64_t queryDuration = (boost::get_system_time() - start).total_microseconds();
+
+	start = boost::get_system_time();
+	for(uint32_t pass = 0; pass < COMBAT_BENCH_WALK_PASSES; ++pass)
+	{
+		for(std::vector<const Tile*>::const_iterator it = tiles.begin(); it != tiles.end(); ++it)
+		{
+			for(uint32_t i = 0; i < propCount; ++i)
+				results += (*it)->hasProperty(props[i]);
+		}
+	}
+
+	uint64_t flagDuration = (boost::get_system_time() - start).total_microseconds();
+
+	start = boost::get_system_time();
+	for(uint32_t pass = 0; pass < COMBAT_BENCH_WALK_PASSES; ++pass)
+	{
+		for(std::vector<const Tile*>::const_iterator it = tiles.begin(); it != tiles.end(); ++it)
+		{
+			for(uint32_t i = 0; i < propCount; ++i)
+				results += hasItemProperty(*it, props[i]);
+		}
+	}
+
+	uint64_t scanDuration = (boost::get_system_time() - start).total_microseconds();
+
+	//real moves, so the tile add and remove paths and their allocations are part of the figure
+	uint32_t moves = 0, failedMoves = 0;
+	uint64_t moveDuration = 0;
+#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+	uint32_t vectorsBefore = StaticTile::vectorCount;
+#endif
+	if(!walkable.empty() && g_game.placeCreature(monster, walkable.front(), false, true))
+	{
+		start = boost::get_system_time();
+		for(uint32_t pass = 0; pass < COMBAT_BENCH_WALK_PASSES; ++pass)
+		{
+			for(std::vector<Position>::const_iterator it = walkable.begin(); it != walkable.end(); ++it)
+			{
+				if(g_game.internalTeleport(monster, *it, false) == RET_NOERROR)
+					++moves;
+				else
+					++failedMoves;
+			}
+
+			g_game.cleanup();
+		}
+
+		moveDuration = (boost::get_system_time() - start).total_microseconds();
+		g_game.removeCreature(monster, false);
+	}
+	else
+		delete monster;
+
+	uint64_t steps = (uint64_t)tiles.size() * COMBAT_BENCH_WALK_PASSES;
+	std::cout << std::endl << "Walk step check:" << std::endl;
+	std::cout << "--------------------" << std::endl;
+	std::cout << "Tiles: " << tiles.size() << " (" << walkable.size() << " walkable for " << config.monsterName << ")" << std::endl;
+	std::cout << "Step queries: " << queryDuration << " us (" << (steps ? queryDuration * 1000 / steps : 0) << " ns per step)" << std::endl;
+	std::cout << "Property flags: " << flagDuration << " us (" << (steps ? flagDuration * 1000 / (steps * propCount) : 0) << " ns per query)" << std::endl;
+	std::cout << "Property scans: " << scanDuration << " us (" << (steps ? scanDuration * 1000 / (steps * propCount) : 0) << " ns per query)" << std::endl;
+	std::cout << "Moves: " << moveDuration << " us (" << moves << " moves, " << failedMoves << " failed, "
+		<< (moves ? moveDuration * 1000 / moves : 0) << " ns per move)" << std::endl;
+#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+	std::cout << "Static tile vectors: " << vectorsBefore << " before moves, " << StaticTile::vectorCount << " after" << std::endl;
+#endif
+	std::cout << "Mismatches: " << mismatches << " (checksum " << results << ")" << std::endl;
+	return mismatches == 0;
+}
+
+bool CombatBench::checkSightLines()
+{
+	if(!loadMap())
+		return false;
+
+	//every pair a creature on the window could shoot at: the client viewport and two floors up or down
+	std::vector<std::pair<Position, Position> > pairs;
+	const Position& center = config.sightCenter;
+	for(int32_t x = center.x - config.sightRadius; x <= center.x + config.sightRadius; ++x)
+	{
+		for(int32_t y = center.y - config.sightRadius; y <= center.y + config.sightRadius; ++y)
+		{
+			Position fromPos(x, y, center.z);
+			for(int32_t z = std::max(0, center.z - 2); z <= std::min(MAP_MAX_LAYERS - 1, center.z + 2); ++z)
+			{
+				for(int32_t dx = -Map::maxClientViewportX; dx <= Map::maxClientViewportX; ++dx)
+				{
+					for(int32_t dy = -Map::maxClientViewportY; dy <= Map::maxClientViewportY; ++dy)
+					{
+						if(x + dx >= 0 && y + dy >= 0)
+							pairs.push_back(std::make_pair(fromPos, Position(x + dx, y + dy, z)));
+					}
+				}
+			}
+		}
+	}
+
+	std::cout << ">> Comparing " << pairs.size() << " sight lines around " << center << std::endl;
+	const Map* map = g_game.getMap();
+
+	std::vector<bool> results(pairs.size());
+	boost::system_time start = boost::get_system_time();
+	for(size_t i = 0; i < pairs.size(); ++i)
+		results[i] = map->checkSightLine(pairs[i].first, pairs[i].second);
+
+	uint64_t bitmapDuration = (boost::get_system_time() - start).total_microseconds();
+
+	uint32_t mismatches = 0;
+	start = boost::get_system_time();
+	for(size_t i = 0; i < pairs.size(); ++i)
+	{
+		if(map->checkSightLineSlow(pairs[i].first, pairs[i].second) == results[i])
+			continue;
+
+		if(++mismatches <= 10)
+			std::cout << "> Mismatch from " << pairs[i].first << " to " << pairs[i].second << ": bitmap says "
+				<< (results[i] ? "clear" : "blocked") << "." << std::endl;
+	}
+
+	uint64_t slowDuration = (boost::get_system_time() - start).total_microseconds();
+
+	std::cout << std::endl << "Sight line check:" << std::endl;
+	std::cout << "--------------------" << std::endl;
+	std::cout << "Lines: " << pairs.size() << " (" << std::count(results.begin(), results.end(), true) << " clear)" << std::endl;
+	std::cout << "Bitmap walk: " << bitmapDuration << " us" << std::endl;
+	std::cout << "Item walk: " << slowDuration << " us (includes the comparison)" << std::endl;
+	std::cout << "Mismatches: " << mismatches << std::endl;
+	return mismatches == 0;
+}
+
+bool CombatBench::checkChat()
+{
+	std::ifstream file(config.chatFile.c_str());
+	if(!file.is_open())
+	{
+		std::cout << "> ERROR: Unable to open " << config.chatFile << "." << std::endl;
+		return false;
+	}
+
+	//the lines as Game::playerSay hands them on, and the trimmed words talkactions match
+	StringVec lines, talkWords;
+	std::string line;
+	while(getline(file, line))
+	{
+		if(!line.empty() && line[line.length() - 1] == '\r')
+			line.erase(line.length() - 1);
+
+		lines.push_back(line);
+		std::string words = line.substr(0, line.find('"'));
+		trim_left(words, " ");
+		trim_right(words, " ");
+		talkWords.push_back(words);
+	}
+
+	std::cout << ">> Looking up " << lines.size() << " chat lines " << COMBAT_BENCH_CHAT_PASSES << " times" << std::endl;
+	uint32_t mismatches = 0, spellHits = 0, talkHits = 0;
+	for(size_t i = 0; i < lines.size(); ++i)
+	{
+		InstantSpell* spell = g_spells->getInstantSpell(lines[i]);
+		if(spell)
+			++spellHits;
+
+		if(spell != g_spells->getInstantSpellSlow(lines[i]) && ++mismatches <= 10)
+			std::cout << "> Spell mismatch for \"" << lines[i] << "\"." << std::endl;
+
+		TalkAction* talkAction = g_talkActions->getTalkAction(talkWords[i]);
+		if(talkAction)
+			++talkHits;
+
+		if(talkAction != g_talkActions->getTalkActionSlow(talkWords[i]) && ++mismatches <= 10)
+			std::cout << "> Talkaction mismatch for \"" << lines[i] << "\"." << std::endl;
+	}
+
+	uint64_t durations[4];
+	for(int32_t lookup = 0; lookup < 4; ++lookup)
+	{
+		boost::system_time start = boost::get_system_time();
+		for(uint32_t pass = 0; pass < COMBAT_BENCH_CHAT_PASSES; ++pass)
+		{
+			for(size_t i = 0; i < lines.size(); ++i)
+			{
+				switch(lookup)
+				{
+					case 0: g_spells->getInstantSpell(lines[i]); break;
+					case 1: g_spells->getInstantSpellSlow(lines[i]); break;
+					case 2: g_talkActions->getTalkAction(talkWords[i]); break;
+					default: g_talkActions->getTalkActionSlow(talkWords[i]); break;
+				}
+			}
+		}
+
+		durations[lookup] = (boost::get_system_time() - start).total_microseconds();
+	}
+
+	uint64_t lookups = (uint64_t)lines.size() * COMBAT_BENCH_CHAT_PASSES;
+	std::cout << std::endl << "Chat lookup check:" << std::endl;
+	std::cout << "--------------------" << std::endl;
+	std::cout << "Lines: " << lines.size() << " (" << spellHits << " spells, " << talkHits << " talkactions)" << std::endl;
+	std::cout << "Spell trie: " << durations[0] << " us (" << (durations[0] ? lookups * 1000000 / durations[0] : 0) << " lines/s)" << std::endl;
+	std::cout << "Spell scan: " << durations[1] << " us (" << (durations[1] ? lookups * 1000000 / durations[1] : 0) << " lines/s)" << std::endl;
+	std::cout << "Talkaction index: " << durations[2] << " us (" << (durations[2] ? lookups * 1000000 / durations[2] : 0) << " lines/s)" << std::endl;
+	std::cout << "Talkaction scan: " << durations[3] << " us (" << (durations[3] ? lookups * 1000000 / durations[3] : 0) << " lines/s)" << std::endl;
+	std::cout << "Mismatches: " << mismatches << std::endl;
+	return mismatches == 0;
+}
+
+bool CombatBench::checkArmor()
+{
+	static const struct
+	{
+		slots_t slot;
+		uint16_t slotPosition;
+	} armorSlots[] =
+	{
+		{SLOT_HEAD, SLOTP_HEAD},
+		{SLOT_NECKLACE, SLOTP_NECKLACE},
+		{SLOT_ARMOR, SLOTP_ARMOR},
+		{SLOT_LEGS, SLOTP_LEGS},
+		{SLOT_FEET, SLOTP_FEET},
+		{SLOT_RING, SLOTP_RING}
+	};
+	const uint32_t slotCount = sizeof(armorSlots) / sizeof(armorSlots[0]);
+
+	std::vector<uint16_t> itemIds[slotCount];
+	for(uint32_t id = 100; id < Item::items.size(); ++id)
+	{
+		const ItemType& it = Item::items[id];
+		if(it.id == 0 || it.armor == 0 || it.slotPosition == (uint16_t)SLOTP_WHEREEVER)
+			continue;
+
+		for(uint32_t i = 0; i < slotCount; ++i)
+		{
+			if(it.slotPosition & armorSlots[i].slotPosition)
+				itemIds[i].push_back(id);
+		}
+	}
+
+	if(players.empty())
+	{
+		std::cout << "> ERROR: The armor check needs at least one player." << std::endl;
+		return false;
+	}
+
+	std::cout << ">> Checking " << config.armorRounds << " equipment changes" << std::endl;
+	uint32_t mismatches = 0, changes = 0;
+	for(uint32_t round = 0; round < config.armorRounds; ++round)
+	{
+		Player* player = players[random_range(0, players.size() - 1)];
+		uint32_t i = random_range(0, slotCount - 1);
+		if(itemIds[i].empty())
+			continue;
+
+		//equip, swap by transforming the equipped item, or take it off
+		Item* item = player->getInventoryItem(armorSlots[i].slot);
+		uint16_t newId = itemIds[i][random_range(0, itemIds[i].size() - 1)];
+		int32_t action = random_range(0, 2);
+		if(!item)
+		{
+			if(Item* newItem = Item::CreateItem(newId))
+			{
+				if(g_game.internalAddItem(player, newItem, armorSlots[i].slot, FLAG_NOLIMIT) == RET_NOERROR)
+					++changes;
+				else
+					delete newItem;
+			}
+		}
+		else if(action == 0 && g_game.internalRemoveItem(item) == RET_NOERROR)
+			++changes;
+		else if(action != 0 && g_game.transformItem(item, newId))
+			++changes;
+
+		//the walk over the slots getArmor did before the armor was cached
+		int32_t armor = 0;
+		for(uint32_t j = 0; j < slotCount; ++j)
+		{
+			if(Item* slotItem = player->getInventoryItem(armorSlots[j].slot))
+				armor += slotItem->getArmor();
+		}
+
+		int32_t expected = int32_t(armor * player->vocation->armorMultipler);
+		if(player->getArmor() == expected)
+			continue;
+
+		if(++mismatches <= 10)
+			std::cout << "> Mismatch for " << player->getName() << " after changing slot " << armorSlots[i].slot << ": getArmor "
+				<< player->getArmor() << ", expected " << expected << "." << std::endl;
+	}
+
+	std::cout << std::endl << "Armor check:" << std::endl;
+	std::cout << "--------------------" << std::endl;
+	std::cout << "Equipment changes: " << changes << std::endl;
+	std::cout << "Mismatches: " << mismatches << std::endl;
+	return mismatches == 0;
+}
+
+Position CombatBench::getPlayerPosition(uint32_t index) const
+{
+	//a row of players has its monster rows right below, slot rows are separated by a free row
+	return Position(COMBAT_BENCH_ORIGIN_X + COMBAT_BENCH_MARGIN + index % config.width,
+		COMBAT_BENCH_ORIGIN_Y + COMBAT_BENCH_MARGIN + (index / config.width) * (config.monsterRows + 2), COMBAT_BENCH_ORIGIN_Z);
+}
+
+Position CombatBench::getMonsterPosition(uint32_t index) const
+{
+	uint32_t monsterRow = index / config.width;
+	return Position(COMBAT_BENCH_ORIGIN_X + COMBAT_BENCH_MARGIN + index % config.width,
+		COMBAT_BENCH_ORIGIN_Y + COMBAT_BENCH_MARGIN + (monsterRow / config.monsterRows) * (config.monsterRows + 2) + 1 + monsterRow % config.monsterRows,
+		COMBAT_BENCH_ORIGIN_Z);
+}
+
+bool CombatBench::isCaster(uint32_t index) const
+{
+	if(config.casters == 0)
+		return true;
+
+	//centered in the first row, so area spells reach monsters on both sides
+	uint32_t firstRow = std::min(config.players, config.width);
+	uint32_t start = (firstRow > config.casters ? (firstRow - config.casters) / 2 : 0);
+	return index >= start && index < start + config.casters;
+}
+
+bool CombatBench::createArena()
+{
+	uint32_t monsterSlots = config.width * config.monsterRows;
+	uint32_t slotRows = std::max<uint32_t>(1, std::max((config.players + config.width - 1) / config.width,
+		(config.monsters + monsterSlots - 1) / monsterSlots));
+
+	Position origin(COMBAT_BENCH_ORIGIN_X, COMBAT_BENCH_ORIGIN_Y, COMBAT_BENCH_ORIGIN_Z);
+	if(!g_game.loadArenaMap(origin, config.width + 2 * COMBAT_BENCH_MARGIN, slotRows * (config.monsterRows + 2) + 2 * COMBAT_BENCH_MARGIN, config.groundId))
+	{
+		std::cout << "> ERROR: Unable to create the arena, item " << config.groundId << " is not a valid ground." << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+bool CombatBench::addPlayer(uint32_t index)
+{
+	std::ostringstream ss;
+	ss << "Bench Player " << (index + 1);
+
+	//the bench protocol makes every combat path build its spectator packets like for a connected client
+	Player* player = new Player(ss.str(), ProtocolGame::createBenchProtocol());
+	player->setVocation(config.vocation);
+	player->level = config.level;
+	player->magLevel = config.magicLevel;
+	player->healthMax = player->health = COMBAT_BENCH_HEALTH;
+	player->manaMax = player->mana = COMBAT_BENCH_HEALTH;
+	player->groupFlags = ((uint64_t)1 << PlayerFlag_IgnoreSpellCheck) | ((uint64_t)1 << PlayerFlag_HasInfiniteMana) |
+		((uint64_t)1 << PlayerFlag_HasInfiniteSoul) | ((uint64_t)1 << PlayerFlag_CannotBeMuted);
+	player->updateBaseSpeed();
+
+	//no login, it would save the player and run the login scripts
+	Position pos = getPlayerPosition(index);
+	if(!g_game.internalPlaceCreature(player, pos, false, true))
+	{
+		std::cout << "> ERROR: Unable to place " << player->getName() << " at " << pos << "." << std::endl;
+		delete player;
+		return false;
+	}
+
+	SpectatorVec list;
+	g_game.getSpectators(list, player->getPosition(), true);
+	for(SpectatorVec::const_iterator it = list.begin(); it != list.end(); ++it)
+		(*it)->onCreatureAppear(player, false);
+
+	g_game.addCreatureCheck(player);
+	players.push_back(player);
+	return true;
+}
+
+bool CombatBench::addMonster(uint32_t index)
+{
+	Monster* monster = Monster::createMonster(config.monsterName);
+	if(!monster)
+	{
+		std::cout << "> ERROR: Unknown monster " << config.monsterName << "." << std::endl;
+		return false;
+	}
+
+	Position pos = getMonsterPosition(index);
+	if(!g_game.placeCreature(monster, pos, false, true))
+	{
+		std::cout << "> ERROR: Unable to place " << monster->getName() << " at " << pos << "." << std::endl;
+		delete monster;
+		return false;
+	}
+
+	monster->useThing2();
+	monsters[index] = monster;
+	return true;
+}
+
+void CombatBench::replaceDeadMonsters()
+{
+	for(uint32_t i = 0; i < monsters.size(); ++i)
+	{
+		Monster* monster = monsters[i];
+		if(monster && !monster->isRemoved())
+			continue;
+
+		if(monster)
+		{
+			monster->releaseThing2();
+			monsters[i] = NULL;
+			++monstersKilled;
+		}
+
+		//keeps the fight going, the slot was checked when the arena was set up
+		addMonster(i);
+	}
+}
+
+void CombatBench::addConditions(uint32_t index)
+{
+	const uint32_t typeCount = sizeof(benchConditionTypes) / sizeof(benchConditionTypes[0]);
+	uint32_t count = std::min(typeCount, (uint32_t)random_range(config.minConditions, std::max(config.minConditions, config.maxConditions)));
+	if(count == 0)
+		return;
+
+	//distinct types, the same type would only refresh the condition already there
+	uint32_t first = random_range(0, typeCount - 1);
+	for(uint32_t i = 0; i < count; ++i)
+	{
+		CombatBenchCondition condition;
+		condition.player = index;
+		condition.type = benchConditionTypes[(first + i) % typeCount].type;
+		condition.param = benchConditionTypes[(first + i) % typeCount].param;
+		condition.endTime = 0;
+		conditions.push_back(condition);
+	}
+}
+
+void CombatBench::renewConditions()
+{
+	//expired conditions come back with a new duration, so every player keeps the same count during the run
+	int64_t timeNow = OTSYS_TIME();
+	for(std::vector<CombatBenchCondition>::iterator it = conditions.begin(); it != conditions.end(); ++it)
+	{
+		if(it->endTime > timeNow)
+			continue;
+
+		int32_t ticks = random_range(1, 60) * 1000;
+		players[it->player]->addCondition(Condition::createCondition(CONDITIONID_COMBAT, it->type, ticks, it->param));
+		if(it->endTime != 0)
+			++conditionsRenewed;
+
+		//one think of slack, the condition ends on the first check after its ticks ran out
+		it->endTime = timeNow + ticks + EVENT_CREATURE_THINK_INTERVAL;
+	}
+}
+
+void CombatBench::updatePlayers(uint32_t tick)
+{
+	for(uint32_t i = 0; i < players.size(); ++i)
+	{
+		//players only take damage, they never die or idle out
+		Player* player = players[i];
+		player->health = player->healthMax;
+		player->resetIdleTime();
+		player->receivePing();
+
+		if(!isCaster(i))
+			continue;
+
+		//the monster right below the player
+		uint32_t targetIndex = (i / config.width) * config.monsterRows * config.width + i % config.width;
+		Monster* target = (monsters.empty() ? NULL : monsters[targetIndex < monsters.size() ? targetIndex : i % monsters.size()]);
+		if(target && !target->isRemoved() && target->getHealth() > 0 && player->getAttackedCreature() != target)
+			player->setAttackedCreature(target);
+
+		if(config.spellInterval != 0 && !spellWords.empty() && (tick + i) % config.spellInterval == 0)
+			g_game.playerSay(player->getID(), 0, SPEAK_SAY, "", spellWords[(tick / config.spellInterval + i) % spellWords.size()]);
+	}
+}
+
+void CombatBench::resetCounters()
+{
+	for(int32_t i = 0; i < COMBAT_PATH_LAST; ++i)
+		Combat::pathStats[i] = CombatPathStats();
+
+	Map::spectatorQueries = Map::spectatorScans = 0;
+	Creature::conditionChecks = Creature::conditionWalks = Creature::conditionWalkTime = 0;
+	Monster::behaviorThinks = Monster::behaviorTime = 0;
+	LuaScriptInterface::callCount = 0;
+	ProtocolGame::packetsWritten = 0;
+}
+
+void CombatBench::printResults(uint64_t duration) const
+{
+	std::cout << std::endl << "Combat benchmark:" << std::endl;
+	std::cout << "--------------------" << std::endl;
+	std::cout << "Ticks: " << config.ticks << " (" << (uint64_t)config.ticks * EVENT_CHECK_CREATURE_INTERVAL << " ms game time)" << std::endl;
+	std::cout << "Time: " << duration << " us (" << (config.ticks ? duration / config.ticks : 0) << " us per tick)" << std::endl;
+	std::cout << "Monsters killed: " << monstersKilled << std::endl;
+	std::cout << "Monster behavior: " << Monster::behaviorThinks << " thinks, " << Monster::behaviorTime << " us ("
+		<< (Monster::behaviorThinks ? Monster::behaviorTime * 1000 / Monster::behaviorThinks : 0) << " ns avg)" << std::endl;
+	if(!conditions.empty())
+	{
+		std::cout << "Conditions renewed: " << conditionsRenewed << std::endl;
+		std::cout << "Condition checks: " << Creature::conditionChecks << " (" << Creature::conditionWalks << " list walks, "
+			<< Creature::conditionWalkTime << " us)" << std::endl;
+	}
+
+	for(int32_t i = 0; i < COMBAT_PATH_LAST; ++i)
+	{
+		const CombatPathStats& pathStats = Combat::pathStats[i];
+		if(!pathStats.calls)
+			continue;
+
+		std::cout << Combat::getPathName((CombatPath_t)i) << ": " << pathStats.calls << " calls, " << pathStats.time << " us total, "
+			<< pathStats.time / pathStats.calls << " us avg, " << pathStats.spectatorQueries << " spectator queries, "
+			<< pathStats.luaCalls << " lua calls, " << pathStats.packets << " packets" << std::endl;
+	}
+
+	std::cout << "Spectator queries: " << Map::spectatorQueries << " (" << Map::spectatorScans << " map scans)" << std::endl;
+	std::cout << "Lua calls: " << LuaScriptInterface::callCount << std::endl;
+	std::cout << "Game packets: " << ProtocolGame::packetsWritten << std::endl;
+	if(CombatLog::isEnabled())
+		std::cout << "Combat log: " << CombatLog::getInstance()->getRecorded() << " events (" << CombatLog::getInstance()->getDropped() << " dropped)" << std::endl;
+}
+#endif
@@ -0,0 +1,137 @@
+//////////////////////////////////////////////////////////////////////
+// OpenTibia - an opensource roleplaying game
+//////////////////////////////////////////////////////////////////////
+// Combat benchmark - replays scripted fights on a synthetic arena
+//////////////////////////////////////////////////////////////////////
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef __OTSERV_COMBATBENCH_H__
+#define __OTSERV_COMBATBENCH_H__
+
+#ifdef __COMBAT_BENCH__
+#ifndef __ENABLE_SERVER_DIAGNOSTIC__
+#error "The combat benchmark reads the server diagnostic counters, build it with __ENABLE_SERVER_DIAGNOSTIC__"
+#endif
+
+#include "definitions.h"
+#include "position.h"
+#include "condition.h"
+
+#include <string>
+#include <vector>
+
+class Player;
+class Monster;
+
+#define COMBAT_BENCH_ORIGIN_X 100
+#define COMBAT_BENCH_ORIGIN_Y 100
+#define COMBAT_BENCH_ORIGIN_Z 7
+#define COMBAT_BENCH_MARGIN 2
+#define COMBAT_BENCH_HEALTH 1000000
+#define COMBAT_BENCH_CHAT_PASSES 1000
+#define COMBAT_BENCH_WALK_PASSES 100
+
+struct CombatBenchConfig
+{
+	CombatBenchConfig() : players(10), monsters(10), ticks(6000), seed(1), width(20),
+		groundId(4526), vocation(1), level(100), magicLevel(50), spellInterval(20), casters(0), monsterRows(1),
+		minConditions(0), maxConditions(0), sightRadius(0), walkRadius(0), armorRounds(0), monsterName("Dragon"), spells("exori vis;exevo gran mas vis;exura") {}
+
+	uint32_t players;
+	uint32_t monsters;
+	uint32_t ticks; //creature check rounds, EVENT_CHECK_CREATURE_INTERVAL ms of game time each
+	uint32_t seed;
+	uint32_t width;
+	uint16_t groundId;
+	uint32_t vocation;
+	uint32_t level;
+	uint32_t magicLevel;
+	uint32_t spellInterval; //ticks between two spells of the same player, 0 disables spells
+	uint32_t casters; //players in the middle of the first row that attack and cast, the others only watch, 0 for all
+	uint32_t monsterRows; //rows of monsters below every row of players
+	uint32_t minConditions; //conditions each player carries, picked between min and max per player
+	uint32_t maxConditions;
+	Position sightCenter; //with a radius, compares the sight line walks on the loaded map instead of fighting
+	int32_t sightRadius;
+	Position walkCenter; //with a radius, times the walk checks of the tiles on the loaded map instead of fighting
+	int32_t walkRadius;
+	uint32_t armorRounds; //random equipment changes checked against the summed slot armor instead of fighting
+	std::string chatFile; //chat lines looked up as spells and talkactions instead of fighting
+	std::string monsterName;
+	std::string spells; //instant spell words separated by ';'
+};
+
+struct CombatBenchCondition
+{
+	uint32_t player;
+	ConditionType_t type;
+	int32_t param;
+	int64_t endTime;
+};
+
+//runs fights without network on a generated map, every run with the same arguments and
+//data pack does the same work because the game clock is advanced by the benchmark itself
+class CombatBench
+{
+	public:
+		~CombatBench() {}
+		static CombatBench* getInstance()
+		{
+			static CombatBench instance;
+			return &instance;
+		}
+
+		//returns true if the command line asks for a benchmark run
+		static bool parseArguments(int argc, char* argv[], CombatBenchConfig& config);
+
+		//called from the dispatcher thread once the data pack is loaded, instead of loading the map
+		bool run(const CombatBenchConfig& _config);
+
+	protected:
+		CombatBench() {}
+
+		bool loadMap();
+		bool checkSightLines();
+		bool checkWalkSteps();
+		bool checkArmor();
+		bool checkChat();
+
+		bool createArena();
+		bool addPlayer(uint32_t index);
+		bool addMonster(uint32_t index);
+		void replaceDeadMonsters();
+		void addConditions(uint32_t index);
+		void renewConditions();
+		void updatePlayers(uint32_t tick);
+		void resetCounters();
+		void printResults(uint64_t duration) const;
+
+		Position getPlayerPosition(uint32_t index) const;
+		Position getMonsterPosition(uint32_t index) const;
+		bool isCaster(uint32_t index) const;
+
+		CombatBenchConfig config;
+		std::vector<std::string> spellWords;
+
+		std::vector<Player*> players;
+		std::vector<Monster*> monsters;
+		std::vector<CombatBenchCondition> conditions;
+		uint32_t monstersKilled;
+		uint32_t conditionsRenewed;
+};
+#endif
+
+#endif
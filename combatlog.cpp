@@ -0,0 +1,281 @@
+//////////////////////////////////////////////////////////////////////
+// OpenTibia - an opensource roleplaying game
+//////////////////////////////////////////////////////////////////////
+// Combat log - records health and mana changes for profiling
+//////////////////////////////////////////////////////////////////////
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//////////////////////////////////////////////////////////////////////
+
+#include "otpch.h"
+
+#include <iostream>
+#include <algorithm>
+#include <boost/bind.hpp>
+
+#include "combatlog.h"
+#include "creature.h"
+#include "scheduler.h"
+#include "tools.h"
+
+bool CombatLog::enabled = false;
+
+CombatLog::CombatLog()
+{
+	running = false;
+	file = NULL;
+	currentSource = NULL;
+	currentAreaSize = 0;
+	currentSpectators = 0;
+	recorded = 0;
+	dropped = 0;
+	flushScheduled = false;
+}
+
+bool CombatLog::start(const std::string& fileName)
+{
+	if(running)
+		return true;
+
+	//the default data/logs directory is not shipped, create it like the command log does
+	std::string::size_type pos = fileName.find_last_of("/\\");
+	if(pos != std::string::npos && pos != 0)
+	{
+		std::string dir = fileName.substr(0, pos);
+		if(!dirExists(dir) && !createDir(dir))
+			std::cout << "[Warning - CombatLog::start] Unable to create directory " << dir << std::endl;
+	}
+
+	file = fopen(fileName.c_str(), "ab");
+	if(!file)
+	{
+		std::cout << "[Error - CombatLog::start] Unable to open " << fileName << std::endl;
+		return false;
+	}
+
+	//every start writes a header, so a file can hold several runs
+	const char header[] = {'C', 'L', 'O', 'G', 1};
+	fwrite(header, 1, sizeof(header), file);
+
+	//sources known from an earlier run are cached by their spells and weapons, announce them again
+	for(SourceMap::const_iterator it = sources.begin(); it != sources.end(); ++it)
+		newSources.push_back(&it->second);
+
+	buffer.reserve(COMBAT_LOG_BUFFER_SIZE);
+	pending.reserve(COMBAT_LOG_BATCH_SIZE);
+	running = true;
+	enabled = true;
+	thread = boost::thread(boost::bind(&CombatLog::writerThread, (void*)this));
+	return true;
+}
+
+void CombatLog::stop()
+{
+	if(!running)
+		return;
+
+	enabled = false;
+	flushPending();
+	{
+		boost::lock_guard<boost::mutex> lockClass(bufferLock);
+		running = false;
+	}
+
+	bufferSignal.notify_one();
+	thread.join();
+
+	fclose(file);
+	file = NULL;
+}
+
+void CombatLog::writerThread(void* p)
+{
+	CombatLog* combatLog = (CombatLog*)p;
+	std::vector<CombatLogEntry> entries;
+	std::vector<const CombatLogSource*> sourceList;
+	entries.reserve(COMBAT_LOG_BUFFER_SIZE);
+
+	boost::unique_lock<boost::mutex> bufferLockUnique(combatLog->bufferLock);
+	while(true)
+	{
+		//one swap per second, so the buffer size is also the limit of events per second
+		boost::system_time flushTime = boost::get_system_time() + boost::posix_time::seconds(1);
+		while(combatLog->running && boost::get_system_time() < flushTime)
+			combatLog->bufferSignal.timed_wait(bufferLockUnique, flushTime);
+
+		entries.swap(combatLog->buffer);
+		sourceList.swap(combatLog->newSources);
+		bool running = combatLog->running;
+		bufferLockUnique.unlock();
+
+		//source records come first, so every event refers to a known source
+		FILE* file = combatLog->file;
+		for(std::vector<const CombatLogSource*>::const_iterator it = sourceList.begin(); it != sourceList.end(); ++it)
+		{
+			uint16_t length = (uint16_t)std::min<size_t>((*it)->name.length(), 0xFFFF);
+			fputc('S', file);
+			fwrite(&(*it)->id, sizeof((*it)->id), 1, file);
+			fwrite(&length, sizeof(length), 1, file);
+			fwrite((*it)->name.c_str(), 1, length, file);
+		}
+
+		for(std::vector<CombatLogEntry>::const_iterator it = entries.begin(); it != entries.end(); ++it)
+		{
+			fputc('E', file);
+			fwrite(&it->time, sizeof(it->time), 1, file);
+			fwrite(&it->casterId, sizeof(it->casterId), 1, file);
+			fwrite(&it->targetId, sizeof(it->targetId), 1, file);
+			fwrite(&it->value, sizeof(it->value), 1, file);
+			fwrite(&it->sourceId, sizeof(it->sourceId), 1, file);
+			fwrite(&it->combatType, sizeof(it->combatType), 1, file);
+			fwrite(&it->areaSize, sizeof(it->areaSize), 1, file);
+			fwrite(&it->spectators, sizeof(it->spectators), 1, file);
+			fputc(it->mana ? 1 : 0, file);
+		}
+
+		if(!entries.empty() || !sourceList.empty())
+			fflush(file);
+
+		entries.clear();
+		sourceList.clear();
+		if(!running)
+			break;
+
+		bufferLockUnique.lock();
+	}
+}
+
+CombatLogSource* CombatLog::getSource(const std::string& name)
+{
+	SourceMap::iterator it = sources.find(name);
+	if(it != sources.end())
+		return &it->second;
+
+	CombatLogSource& source = sources[name];
+	source.id = (uint16_t)sources.size();
+	source.name = name;
+
+	boost::lock_guard<boost::mutex> lockClass(bufferLock);
+	newSources.push_back(&source);
+	return &source;
+}
+
+void CombatLog::record(const Creature* caster, const Creature* target, CombatType_t combatType, int32_t value, bool mana)
+{
+	if(!currentSource)
+		currentSource = getSource("other");
+
+	CombatLogSource* source = currentSource;
+	++source->events;
+	source->totalValue += std::abs(value);
+	source->maxAreaSize = std::max(source->maxAreaSize, currentAreaSize);
+	source->maxSpectators = std::max(source->maxSpectators, currentSpectators);
+	++recorded;
+
+	CombatLogEntry entry;
+	entry.time = OTSYS_TIME();
+	entry.casterId = (caster ? caster->getID() : 0);
+	entry.targetId = target->getID();
+	entry.value = value;
+	entry.sourceId = source->id;
+	entry.combatType = (uint16_t)combatType;
+	entry.areaSize = (uint16_t)std::min<uint32_t>(currentAreaSize, 0xFFFF);
+	entry.spectators = (uint16_t)std::min<uint32_t>(currentSpectators, 0xFFFF);
+	entry.mana = mana;
+
+	//the lock is only taken once per batch, a slow fight is handed over by the scheduler within a second
+	pending.push_back(entry);
+	if(pending.size() >= COMBAT_LOG_BATCH_SIZE)
+		flushPending();
+	else if(!flushScheduled)
+	{
+		flushScheduled = true;
+		g_scheduler.addEvent(createSchedulerTask(1000, boost::bind(&CombatLog::scheduledFlush, this)));
+	}
+}
+
+void CombatLog::scheduledFlush()
+{
+	flushScheduled = false;
+	flushPending();
+}
+
+void CombatLog::flushPending()
+{
+	if(pending.empty())
+		return;
+
+	boost::lock_guard<boost::mutex> lockClass(bufferLock);
+	size_t count = std::min(pending.size(), COMBAT_LOG_BUFFER_SIZE - buffer.size());
+	buffer.insert(buffer.end(), pending.begin(), pending.begin() + count);
+	dropped += pending.size() - count;
+	pending.clear();
+}
+
+static bool compareSourceEvents(const CombatLogSource* a, const CombatLogSource* b)
+{
+	return a->events > b->events;
+}
+
+void CombatLog::getTopSources(std::vector<const CombatLogSource*>& list, uint32_t count) const
+{
+	list.clear();
+	for(SourceMap::const_iterator it = sources.begin(); it != sources.end(); ++it)
+		list.push_back(&it->second);
+
+	std::sort(list.begin(), list.end(), compareSourceEvents);
+	if(list.size() > count)
+		list.resize(count);
+}
+
+CombatLogScope::CombatLogScope(CombatLogSource*& source, const std::string& name)
+{
+	active = CombatLog::isEnabled();
+	if(!active)
+		return;
+
+	CombatLog* combatLog = CombatLog::getInstance();
+	previousSource = combatLog->currentSource;
+	previousAreaSize = combatLog->currentAreaSize;
+	previousSpectators = combatLog->currentSpectators;
+	if(!source)
+		source = combatLog->getSource(name);
+
+	combatLog->currentSource = source;
+}
+
+CombatLogScope::CombatLogScope(uint32_t areaSize, uint32_t spectators)
+{
+	active = CombatLog::isEnabled();
+	if(!active)
+		return;
+
+	CombatLog* combatLog = CombatLog::getInstance();
+	previousSource = combatLog->currentSource;
+	previousAreaSize = combatLog->currentAreaSize;
+	previousSpectators = combatLog->currentSpectators;
+	combatLog->currentAreaSize = areaSize;
+	combatLog->currentSpectators = spectators;
+}
+
+CombatLogScope::~CombatLogScope()
+{
+	if(!active)
+		return;
+
+	CombatLog* combatLog = CombatLog::getInstance();
+	combatLog->currentSource = previousSource;
+	combatLog->currentAreaSize = previousAreaSize;
+	combatLog->currentSpectators = previousSpectators;
+}
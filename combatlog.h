@@ -0,0 +1,137 @@
+//////////////////////////////////////////////////////////////////////
+// OpenTibia - an opensource roleplaying game
+//////////////////////////////////////////////////////////////////////
+// Combat log - records health and mana changes for profiling
+//////////////////////////////////////////////////////////////////////
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef __OTSERV_COMBATLOG_H__
+#define __OTSERV_COMBATLOG_H__
+
+#include "definitions.h"
+#include "enums.h"
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include <boost/thread.hpp>
+
+#define COMBAT_LOG_BUFFER_SIZE 65536
+#define COMBAT_LOG_BATCH_SIZE 256
+
+class Creature;
+
+struct CombatLogEntry
+{
+	int64_t time;
+	uint32_t casterId;
+	uint32_t targetId;
+	int32_t value;
+	uint16_t sourceId;
+	uint16_t combatType;
+	uint16_t areaSize;
+	uint16_t spectators;
+	bool mana;
+};
+
+struct CombatLogSource
+{
+	CombatLogSource() : id(0), events(0), totalValue(0), maxAreaSize(0), maxSpectators(0) {}
+
+	uint16_t id;
+	std::string name;
+	uint64_t events;
+	uint64_t totalValue;
+	uint32_t maxAreaSize;
+	uint32_t maxSpectators;
+};
+
+class CombatLog
+{
+	public:
+		~CombatLog() {}
+		static CombatLog* getInstance()
+		{
+			static CombatLog instance;
+			return &instance;
+		}
+
+		static bool isEnabled() {return enabled;}
+
+		bool start(const std::string& fileName);
+		void stop();
+
+		//called from the dispatcher thread only
+		void record(const Creature* caster, const Creature* target, CombatType_t combatType, int32_t value, bool mana);
+		void getTopSources(std::vector<const CombatLogSource*>& list, uint32_t count) const;
+
+		uint64_t getRecorded() const {return recorded;}
+		uint64_t getDropped() const {return dropped;}
+
+	protected:
+		CombatLog();
+		friend class CombatLogScope;
+
+		CombatLogSource* getSource(const std::string& name);
+		static void writerThread(void* p);
+
+		static bool enabled;
+		bool running;
+		FILE* file;
+
+		boost::thread thread;
+		boost::mutex bufferLock;
+		boost::condition_variable bufferSignal;
+
+		//filled by the dispatcher without locking, handed to the buffer in batches
+		void flushPending();
+		void scheduledFlush();
+		std::vector<CombatLogEntry> pending;
+		bool flushScheduled;
+
+		//filled from the pending events and swapped out by the writer thread
+		std::vector<CombatLogEntry> buffer;
+		std::vector<const CombatLogSource*> newSources;
+
+		typedef std::map<std::string, CombatLogSource> SourceMap;
+		SourceMap sources;
+
+		CombatLogSource* currentSource;
+		uint32_t currentAreaSize;
+		uint32_t currentSpectators;
+
+		uint64_t recorded;
+		uint64_t dropped;
+};
+
+//sets the source or area that recorded events are attributed to until it goes out of scope
+class CombatLogScope
+{
+	public:
+		//source is the cache of the caller, it is only looked up by name while still NULL
+		CombatLogScope(CombatLogSource*& source, const std::string& name);
+		CombatLogScope(uint32_t areaSize, uint32_t spectators);
+		~CombatLogScope();
+
+	private:
+		bool active;
+		CombatLogSource* previousSource;
+		uint32_t previousAreaSize;
+		uint32_t previousSpectators;
+};
+
+#endif
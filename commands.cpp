@@ -53,6 +53,7 @@
 #include "admin.h"
 #include "status.h"
 #include "protocollogin.h"
+#include "combatlog.h"
 #endif
 
 #include <libxml/xmlmemory.h>
@@ -610,6 +611,9 @@ void Commands::reloadInfo(Player* player, const std::string& cmd, const std::str
 	else if(tmpParam == "items")
 	{
 		Item::items.reload();
+		for(AutoList<Player>::listiterator it = Player::listPlayer.list.begin(); it != Player::listPlayer.list.end(); ++it)
+			it->second->updateInventoryArmor();
+
 		player->sendTextMessage(MSG_STATUS_CONSOLE_BLUE, "Reloaded items.");
 	}
 	else if(tmpParam == "weapon" || tmpParam == "weapons")
@@ -1370,10 +1374,11 @@ void Commands::unban(Player* player, const std::string& cmd, const std::string&
 void Commands::playerKills(Player* player, const std::string& cmd, const std::string& param)
 {
 	int32_t fragTime = g_config.getNumber(ConfigManager::FRAG_TIME);
-	if(player->skullTicks && fragTime > 0)
+	int64_t skullTicks = player->getSkullTicks();
+	if(skullTicks && fragTime > 0)
 	{
-		int32_t frags = (int32_t)ceil(player->skullTicks / (double)fragTime);
-		int32_t remainingTime = (player->skullTicks % fragTime) / 1000;
+		int32_t frags = (int32_t)ceil(skullTicks / (double)fragTime);
+		int32_t remainingTime = (skullTicks % fragTime) / 1000;
 		int32_t hours = remainingTime / 3600;
 		int32_t minutes = (remainingTime % 3600) / 60;
 
@@ -1407,6 +1412,73 @@ void Commands::serverDiag(Player* player, const std::string& cmd, const std::str
 	text << "Player: " << g_game.getPlayersOnline() << " (" << Player::playerCount << ")\n";
 	text << "Npc: " << g_game.getNpcsOnline() << " (" << Npc::npcCount << ")\n";
 	text << "Monster: " << g_game.getMonstersOnline() << " (" << Monster::monsterCount << ")\n";
+	text << "Static tile vectors: " << StaticTile::vectorCount << "\n";
+	text << "Monster behavior: " << Monster::behaviorThinks << " thinks, " << Monster::behaviorTime << " us\n";
+
+	const CreatureCheckStats& checkStats = g_game.getCreatureCheckStats();
+	text << "\nCreature checks:" << "\n";
+	text << "--------------------\n";
+	text << "Buckets:";
+	for(int32_t i = 0; i < EVENT_CREATURECOUNT; ++i)
+		text << " " << g_game.getCreatureCheckBucketSize(i);
+
+	text << "\n";
+	text << "Checks: " << checkStats.buckets << " (" << checkStats.overloaded << " overloaded)\n";
+	text << "Deferred thinks: " << checkStats.deferred << "\n";
+	text << "Tick lag: " << checkStats.lastLag << " ms (max " << checkStats.maxLag << " ms)\n";
+	text << "Bucket time: " << checkStats.lastDuration << " us (max " << checkStats.maxDuration << " us)\n";
+	text << "Condition checks: " << Creature::conditionChecks << " (" << Creature::conditionWalks << " list walks, "
+		<< Creature::conditionWalkTime << " us)\n";
+
+	text << "\nPlayer updates:" << "\n";
+	text << "--------------------\n";
+	text << "Stats packets: " << Player::statsSent << " (" << Player::statsRequested << " requested)\n";
+	text << "Skull checks: " << Player::skullChecks << " (" << Player::skullChecksSkipped << " skipped)\n";
+	for(int32_t i = 0; i < PLAYER_SUBSYSTEM_LAST; ++i)
+	{
+		const PlayerSubsystemStats& subsystemStats = Player::subsystemStats[i];
+		if(!subsystemStats.calls)
+			continue;
+
+		text << Player::getSubsystemName((PlayerSubsystem_t)i) << ": " << subsystemStats.calls << " calls, "
+			<< subsystemStats.time << " us total, " << subsystemStats.time / subsystemStats.calls << " us avg\n";
+	}
+
+	const SpawnCheckStats& spawnStats = Spawns::getInstance()->getCheckStats();
+	text << "\nSpawn checks:" << "\n";
+	text << "--------------------\n";
+	text << "Ticks: " << spawnStats.ticks << " (" << spawnStats.lastChecked << " spawns last tick)\n";
+	text << "Tick time: " << spawnStats.lastDuration << " ms (max " << spawnStats.maxDuration << " ms)\n";
+	text << "Player lookups: " << spawnStats.playerQueries << " (" << spawnStats.gridSkips << " skipped by grid)\n";
+
+	text << "\nCombat paths:" << "\n";
+	text << "--------------------\n";
+	for(int32_t i = 0; i < COMBAT_PATH_LAST; ++i)
+	{
+		const CombatPathStats& pathStats = Combat::pathStats[i];
+		if(!pathStats.calls)
+			continue;
+
+		text << Combat::getPathName((CombatPath_t)i) << ": " << pathStats.calls << " calls, " << pathStats.time / pathStats.calls << " us avg, "
+			<< pathStats.spectatorQueries << " spectator queries, " << pathStats.luaCalls << " lua calls, " << pathStats.packets << " packets\n";
+	}
+
+	text << "Spectator queries: " << Map::spectatorQueries << " (" << Map::spectatorScans << " map scans)\n";
+	text << "Lua calls: " << LuaScriptInterface::callCount << "\n";
+	text << "Game packets: " << ProtocolGame::packetsWritten << "\n";
+
+	if(CombatLog::isEnabled())
+	{
+		CombatLog* combatLog = CombatLog::getInstance();
+		text << "\nCombat log:" << "\n";
+		text << "--------------------\n";
+		text << "Events: " << combatLog->getRecorded() << " (" << combatLog->getDropped() << " dropped)\n";
+
+		std::vector<const CombatLogSource*> sourceList;
+		combatLog->getTopSources(sourceList, 10);
+		for(std::vector<const CombatLogSource*>::const_iterator it = sourceList.begin(); it != sourceList.end(); ++it)
+			text << (*it)->name << ": " << (*it)->events << " events, " << (*it)->totalValue << " total, max area " << (*it)->maxAreaSize << ", max spectators " << (*it)->maxSpectators << "\n";
+	}
 
 	text << "\nProtocols:" << "\n";
 	text << "--------------------\n";
@@ -152,7 +152,7 @@ bool Condition::serialize(PropWriteStream& propWriteStream)
 	propWriteStream.ADD_VALUE((int32_t)id);
 
 	propWriteStream.ADD_UCHAR(CONDITIONATTR_TICKS);
-	propWriteStream.ADD_VALUE((int32_t)ticks);
+	propWriteStream.ADD_VALUE((int32_t)getTicks());
 
 	propWriteStream.ADD_UCHAR(CONDITIONATTR_ISBUFF);
 	propWriteStream.ADD_VALUE((int8_t)isBuff);
@@ -162,6 +162,15 @@ bool Condition::serialize(PropWriteStream& propWriteStream)
 	return true;
 }
 
+int32_t Condition::getTicks() const
+{
+	//passive conditions are not executed every think, their remaining time comes from endTime
+	if(ticks <= 0 || endTime == 0 || hasTickEvents())
+		return ticks;
+
+	return (int32_t)std::max<int64_t>(0, endTime - OTSYS_TIME());
+}
+
 void Condition::setTicks(int32_t newTicks)
 {
 	ticks = newTicks;
@@ -891,6 +900,12 @@ bool ConditionRegeneration::executeCondition(Creature* creature, int32_t interva
 	return ConditionGeneric::executeCondition(creature, interval);
 }
 
+int32_t ConditionRegeneration::getNextTickDelay() const
+{
+	return std::max<int32_t>(0, std::min<int32_t>((int32_t)healthTicks - (int32_t)internalHealthTicks,
+		(int32_t)manaTicks - (int32_t)internalManaTicks));
+}
+
 bool ConditionRegeneration::setParam(ConditionParam_t param, int32_t value)
 {
 	bool ret = ConditionGeneric::setParam(param, value);
@@ -995,6 +1010,11 @@ bool ConditionSoul::executeCondition(Creature* creature, int32_t interval)
 	return ConditionGeneric::executeCondition(creature, interval);
 }
 
+int32_t ConditionSoul::getNextTickDelay() const
+{
+	return std::max<int32_t>(0, (int32_t)soulTicks - (int32_t)internalSoulTicks);
+}
+
 bool ConditionSoul::setParam(ConditionParam_t param, int32_t value)
 {
 	bool ret = ConditionGeneric::setParam(param, value);
@@ -1273,6 +1293,15 @@ bool ConditionDamage::executeCondition(Creature* creature, int32_t interval)
 	return Condition::executeCondition(creature, interval);
 }
 
+int32_t ConditionDamage::getNextTickDelay() const
+{
+	//interval lists check the field under the creature on every think
+	if(periodDamage == 0)
+		return 0;
+
+	return std::max<int32_t>(0, tickInterval - periodDamageTick);
+}
+
 bool ConditionDamage::getNextDamage(int32_t& damage)
 {
 	if(periodDamage != 0)
@@ -1773,6 +1802,11 @@ bool ConditionLight::executeCondition(Creature* creature, int32_t interval)
 	return Condition::executeCondition(creature, interval);
 }
 
+int32_t ConditionLight::getNextTickDelay() const
+{
+	return std::max<int32_t>(0, (int32_t)lightChangeInterval - (int32_t)internalLightTicks);
+}
+
 void ConditionLight::endCondition(Creature* creature, ConditionEnd_t reason)
 {
 	creature->setNormalCreatureLight();
@@ -131,9 +131,14 @@ class Condition
 
 		ConditionType_t getType() const {return conditionType;}
 		int64_t getEndTime() const {return endTime;}
-		int32_t getTicks() const {return ticks;}
+		int32_t getTicks() const;
 		void setTicks(int32_t newTicks);
 
+		//conditions without periodic work only need to be visited once they expire
+		virtual bool hasTickEvents() const {return false;}
+		//think time in ms until the next periodic event, 0 asks for every think
+		virtual int32_t getNextTickDelay() const {return 0;}
+
 		static Condition* createCondition(ConditionId_t _id, ConditionType_t _type, int32_t ticks, int32_t param = 0, bool _buff = false, uint32_t _subId = 0);
 		static Condition* createCondition(PropStream& propStream);
 
@@ -222,6 +227,8 @@ class ConditionRegeneration : public ConditionGeneric
 
 		virtual void addCondition(Creature* creature, const Condition* addCondition);
 		virtual bool executeCondition(Creature* creature, int32_t interval);
+		virtual bool hasTickEvents() const {return true;}
+		virtual int32_t getNextTickDelay() const;
 
 		virtual bool setParam(ConditionParam_t param, int32_t value);
 
@@ -249,6 +256,8 @@ class ConditionSoul : public ConditionGeneric
 
 		virtual void addCondition(Creature* creature, const Condition* addCondition);
 		virtual bool executeCondition(Creature* creature, int32_t interval);
+		virtual bool hasTickEvents() const {return true;}
+		virtual int32_t getNextTickDelay() const;
 
 		virtual bool setParam(ConditionParam_t param, int32_t value);
 
@@ -286,6 +295,8 @@ class ConditionDamage: public Condition
 
 		virtual bool startCondition(Creature* creature);
 		virtual bool executeCondition(Creature* creature, int32_t interval);
+		virtual bool hasTickEvents() const {return true;}
+		virtual int32_t getNextTickDelay() const;
 		virtual void endCondition(Creature* creature, ConditionEnd_t reason);
 		virtual void addCondition(Creature* creature, const Condition* condition);
 		virtual uint32_t getIcons() const;
@@ -391,6 +402,8 @@ class ConditionLight: public Condition
 
 		virtual bool startCondition(Creature* creature);
 		virtual bool executeCondition(Creature* creature, int32_t interval);
+		virtual bool hasTickEvents() const {return true;}
+		virtual int32_t getNextTickDelay() const;
 		virtual void endCondition(Creature* creature, ConditionEnd_t reason);
 		virtual void addCondition(Creature* creature, const Condition* addCondition);
 
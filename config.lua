@@ -33,6 +33,12 @@
 	oldConditionAccuracy = "no"
 	stairJumpExhaustion = 2000
 
+	-- Combat Log
+	-- note: records every health and mana change into combatLogFile and
+	-- shows the busiest sources in /serverdiag. Meant for profiling only.
+	combatLogEnabled = "no"
+	combatLogFile = "data/logs/combat.log"
+
 	-- Commands
 	displayGamemastersWithOnlineCommand = "no"
 
@@ -76,11 +82,22 @@
 
 	-- Idle
 	kickIdlePlayerAfterMinutes = 15
+	-- note: hibernateNpcs stops NPCs from thinking while no player can see
+	-- them, which also pauses their onThink scripts until a player comes by.
+	-- hibernateNpcRange narrows that to players within so many tiles on the
+	-- same floor (never less than the NPC's talk radius), 0 uses the whole viewport.
+	hibernateNpcs = "no"
+	hibernateNpcRange = 0
 
 	-- Item Usage
 	timeBetweenActions = 200
 	timeBetweenExActions = 1000
 
+	-- Loot
+	-- note: a lootSeed other than 0 makes every start roll the same loot,
+	-- which allows testing drop rates. Keep it at 0 on a live server.
+	lootSeed = 0
+
 	-- Map
 	mapName = "forgotten"
 	mapAuthor = "Komic"
@@ -134,8 +151,11 @@
 	saveGlobalStorage = "no"
 
 	-- Spawns
+	-- note: while the server is behind, monsters without a player within
+	-- deferThinkRange tiles only think every other second.
 	deSpawnRange = 2
 	deSpawnRadius = 50
+	deferThinkRange = 8
 
 	-- Stamina
 	staminaSystem = "yes"
@@ -57,6 +57,7 @@ bool ConfigManager::loadFile(const std::string& _filename)
 		m_confBoolean[INGAME_GUILD_SYSTEM] = booleanString(getGlobalString(L, "ingameGuildSystem", "yes"));
 		m_confBoolean[BIND_ONLY_GLOBAL_ADDRESS] = booleanString(getGlobalString(L, "bindOnlyGlobalAddress", "no"));
 		m_confBoolean[OPTIMIZE_DATABASE] = booleanString(getGlobalString(L, "startupDatabaseOptimization", "yes"));
+		m_confBoolean[COMBAT_LOG_ENABLED] = booleanString(getGlobalString(L, "combatLogEnabled", "no"));
 
 		m_confString[CONFIG_FILE] = _filename;
 		m_confString[IP] = getGlobalString(L, "ip", "127.0.0.1");
@@ -69,6 +70,7 @@ bool ConfigManager::loadFile(const std::string& _filename)
 		m_confString[MYSQL_DB] = getGlobalString(L, "mysqlDatabase", "theforgottenserver");
 		m_confString[SQLITE_DB] = getGlobalString(L, "sqliteDatabase");
 		m_confString[PASSWORDTYPE] = getGlobalString(L, "passwordType", "plain");
+		m_confString[COMBAT_LOG_FILE] = getGlobalString(L, "combatLogFile", "data/logs/combat.log");
 		#ifdef MULTI_SQL_DRIVERS
 		m_confString[SQL_TYPE] = getGlobalString(L, "sqlType", "sqlite");
 		#endif
@@ -110,6 +112,7 @@ bool ConfigManager::loadFile(const std::string& _filename)
 	m_confBoolean[MARKET_ENABLED] = booleanString(getGlobalString(L, "marketEnabled", "yes"));
 	m_confBoolean[MARKET_PREMIUM] = booleanString(getGlobalString(L, "premiumToCreateMarketOffer", "yes"));
 	m_confBoolean[STAMINA_SYSTEM] = booleanString(getGlobalString(L, "staminaSystem", "yes"));
+	m_confBoolean[HIBERNATE_NPCS] = booleanString(getGlobalString(L, "hibernateNpcs", "no"));
 
 	m_confString[DEFAULT_PRIORITY] = getGlobalString(L, "defaultPriority", "high");
 	m_confString[MAP_STORAGE_TYPE] = getGlobalString(L, "mapStorageType", "relational");
@@ -151,6 +154,7 @@ bool ConfigManager::loadFile(const std::string& _filename)
 	m_confInteger[MAX_MESSAGEBUFFER] = getGlobalNumber(L, "maxMessageBuffer", 4);
 	m_confInteger[CRITICAL_HIT_CHANCE] = getGlobalNumber(L, "criticalHitChance", 5);
 	m_confInteger[KICK_AFTER_MINUTES] = getGlobalNumber(L, "kickIdlePlayerAfterMinutes", 15);
+	m_confInteger[HIBERNATE_NPC_RANGE] = getGlobalNumber(L, "hibernateNpcRange", 0);
 	m_confInteger[PROTECTION_LEVEL] = getGlobalNumber(L, "protectionLevel", 1);
 	m_confInteger[DEATH_LOSE_PERCENT] = getGlobalNumber(L, "deathLosePercent", -1);
 	m_confInteger[STATUSQUERY_TIMEOUT] = getGlobalNumber(L, "statusTimeout", 5 * 60 * 1000);
@@ -163,6 +167,8 @@ bool ConfigManager::loadFile(const std::string& _filename)
 	m_confInteger[MAX_GUILD_NAME] = getGlobalNumber(L, "maxGuildNameLength", 20);
 	m_confInteger[CHECK_EXPIRED_MARKET_OFFERS_EACH_MINUTES] = getGlobalNumber(L, "checkExpiredMarketOffersEachMinutes", 60);
 	m_confInteger[MAX_MARKET_OFFERS_AT_A_TIME_PER_PLAYER] = getGlobalNumber(L, "maxMarketOffersAtATimePerPlayer", 100);
+	m_confInteger[CREATURE_DEFER_RANGE] = getGlobalNumber(L, "deferThinkRange", 8);
+	m_confInteger[LOOT_SEED] = getGlobalNumber(L, "lootSeed", 0);
 
 	m_isLoaded = true;
 	lua_close(L);
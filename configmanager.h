@@ -69,6 +69,8 @@ class ConfigManager
 			MARKET_ENABLED,
 			MARKET_PREMIUM,
 			STAMINA_SYSTEM,
+			HIBERNATE_NPCS,
+			COMBAT_LOG_ENABLED,
 			LAST_BOOLEAN_CONFIG /* this must be the last one */
 		};
 
@@ -100,6 +102,7 @@ class ConfigManager
 			PASSWORDTYPE,
 			MAP_AUTHOR,
 			MAP_STORAGE_TYPE,
+			COMBAT_LOG_FILE,
 			LAST_STRING_CONFIG /* this must be the last one */
 		};
 
@@ -136,6 +139,7 @@ class ConfigManager
 			EX_ACTIONS_DELAY_INTERVAL,
 			CRITICAL_HIT_CHANCE,
 			KICK_AFTER_MINUTES,
+			HIBERNATE_NPC_RANGE,
 			PROTECTION_LEVEL,
 			DEATH_LOSE_PERCENT,
 			PASSWORD_TYPE,
@@ -154,6 +158,8 @@ class ConfigManager
 			MARKET_OFFER_DURATION,
 			CHECK_EXPIRED_MARKET_OFFERS_EACH_MINUTES,
 			MAX_MARKET_OFFERS_AT_A_TIME_PER_PLAYER,
+			CREATURE_DEFER_RANGE,
+			LOOT_SEED,
 			LAST_INTEGER_CONFIG /* this must be the last one */
 		};
 
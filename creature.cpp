@@ -32,6 +32,7 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <limits>
 
 #if defined __EXCEPTION_TRACER__
 #include "exception.h"
@@ -45,6 +46,12 @@ double Creature::speedA = 857.36;
 double Creature::speedB = 261.29;
 double Creature::speedC = -4795.01;
 
+#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+uint64_t Creature::conditionChecks = 0;
+uint64_t Creature::conditionWalks = 0;
+uint64_t Creature::conditionWalkTime = 0;
+#endif
+
 extern Game g_game;
 extern ConfigManager g_config;
 extern CreatureEvents* g_creatureEvents;
@@ -66,6 +73,7 @@ Creature::Creature() :
 
 	lastStep = 0;
 	lastStepCost = 1;
+	walkSlotDelay = 0;
 	baseSpeed = 220;
 	varSpeed = 0;
 
@@ -95,6 +103,10 @@ Creature::Creature() :
 	walkUpdateTicks = 0;
 	checkCreatureVectorIndex = -1;
 	creatureCheck = false;
+	checkCreatureDeferredTicks = 0;
+	conditionsCheckTime = 0;
+	conditionsTickDelay = -1;
+	conditionsSkippedInterval = 0;
 	scriptEventsBitField = 0;
 
 	hiddenHealth = false;
@@ -278,6 +290,11 @@ void Creature::onWalk()
 
 				forceUpdateFollowPath = true;
 			}
+			else
+			{
+				//the step was due before its slot ran, count it from then so the rounding does not add up
+				lastStep -= walkSlotDelay;
+			}
 		}
 		else
 		{
@@ -295,6 +312,7 @@ void Creature::onWalk()
 		cancelNextWalk = false;
 	}
 
+	walkSlotDelay = 0;
 	if(eventWalk != 0)
 	{
 		eventWalk = 0;
@@ -367,17 +385,14 @@ void Creature::addEventWalk(bool firstStep)
 	if(ticks == 1)
 		g_game.checkCreatureWalk(getID());
 
-	eventWalk = g_scheduler.addEvent(createSchedulerTask(
-		std::max<int64_t>(SCHEDULER_MINTICKS, ticks), boost::bind(&Game::checkCreatureWalk, &g_game, getID())));
+	eventWalk = g_game.addCreatureWalk(this, std::max<int64_t>(SCHEDULER_MINTICKS, ticks));
 }
 
 void Creature::stopEventWalk()
 {
-	if(eventWalk != 0)
-	{
-		g_scheduler.stopEvent(eventWalk);
-		eventWalk = 0;
-	}
+	//the slot is shared with other creatures, it skips us once the ids no longer match
+	eventWalk = 0;
+	walkSlotDelay = 0;
 }
 
 void Creature::updateMapCache()
@@ -1321,6 +1336,16 @@ bool Creature::addCondition(Condition* condition, bool force/* = false*/)
 		}
 	}
 
+	//hand the skipped think time to the current conditions first, the new one must not get it
+	if(conditionsSkippedInterval > 0)
+	{
+		invalidateConditionsCheck();
+		executeConditions(0);
+	}
+
+	//the new or refreshed condition may expire before the scheduled check
+	invalidateConditionsCheck();
+
 	Condition* prevCond = getCondition(condition->getType(), condition->getId(), condition->getSubId());
 	if(prevCond)
 	{
@@ -1466,9 +1491,30 @@ Condition* Creature::getCondition(ConditionType_t type, ConditionId_t id, uint32
 
 void Creature::executeConditions(uint32_t interval)
 {
+#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+	conditionChecks++;
+#endif
+	//nothing expires and no periodic event is due yet
+	int32_t elapsed = conditionsSkippedInterval + interval;
+	if(conditionsCheckTime != 0 && conditionsCheckTime >= OTSYS_TIME()
+		&& conditionsTickDelay != 0 && (conditionsTickDelay == -1 || elapsed < conditionsTickDelay))
+	{
+		conditionsSkippedInterval = elapsed;
+		return;
+	}
+
+	conditionsSkippedInterval = 0;
+
+#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+	conditionWalks++;
+	boost::system_time walkStart = boost::get_system_time();
+#endif
+	int64_t nextCheck = std::numeric_limits<int64_t>::max();
+	int32_t tickDelay = -1;
+	bool ended = false;
 	for(ConditionList::iterator it = conditions.begin(); it != conditions.end();)
 	{
-		if(!(*it)->executeCondition(this, interval))
+		if(!(*it)->executeCondition(this, elapsed))
 		{
 			ConditionType_t type = (*it)->getType();
 
@@ -1479,10 +1525,29 @@ void Creature::executeConditions(uint32_t interval)
 			delete condition;
 
 			onEndCondition(type);
+			ended = true;
 		}
 		else
+		{
+			if((*it)->hasTickEvents())
+			{
+				int32_t delay = (*it)->getNextTickDelay();
+				tickDelay = (tickDelay == -1 ? delay : std::min(tickDelay, delay));
+			}
+
+			if((*it)->getTicks() != -1)
+				nextCheck = std::min(nextCheck, (*it)->getEndTime());
+
 			++it;
+		}
 	}
+
+	//ending a condition may have changed the list, look again on the next think
+	conditionsCheckTime = (ended ? 0 : nextCheck);
+	conditionsTickDelay = tickDelay;
+#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+	conditionWalkTime += (boost::get_system_time() - walkStart).total_microseconds();
+#endif
 }
 
 bool Creature::hasCondition(ConditionType_t type, uint32_t subId/* = 0*/) const
@@ -89,6 +89,7 @@ class Tile;
 #define EVENT_CREATURECOUNT 10
 #define EVENT_CREATURE_THINK_INTERVAL 1000
 #define EVENT_CHECK_CREATURE_INTERVAL (EVENT_CREATURE_THINK_INTERVAL / EVENT_CREATURECOUNT)
+#define EVENT_WALK_SLOT_INTERVAL 10
 
 class FrozenPathingConditionCall
 {
@@ -117,6 +118,11 @@ class Creature : public AutoID, virtual public Thing
 
 	public:
 		static double speedA, speedB, speedC;
+#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+		static uint64_t conditionChecks;
+		static uint64_t conditionWalks;
+		static uint64_t conditionWalkTime;
+#endif
 
 		virtual ~Creature();
 
@@ -254,6 +260,8 @@ class Creature : public AutoID, virtual public Thing
 		Condition* getCondition(ConditionType_t type) const;
 		Condition* getCondition(ConditionType_t type, ConditionId_t id, uint32_t subId = 0) const;
 		void executeConditions(uint32_t interval);
+		//call after changing the ticks of a condition outside executeConditions
+		void invalidateConditionsCheck() {conditionsCheckTime = 0;}
 		bool hasCondition(ConditionType_t type, uint32_t subId = 0) const;
 		virtual bool isImmune(ConditionType_t type) const;
 		virtual bool isImmune(CombatType_t type) const;
@@ -376,6 +384,8 @@ class Creature : public AutoID, virtual public Thing
 		// -1 represents that the creature isn't in any vector
 		int32_t checkCreatureVectorIndex;
 		bool creatureCheck;
+		// Think time skipped while the creature checks were overloaded
+		uint32_t checkCreatureDeferredTicks;
 
 		int32_t health, healthMax;
 		int32_t mana, manaMax;
@@ -388,12 +398,19 @@ class Creature : public AutoID, virtual public Thing
 		int32_t masterRadius;
 		uint64_t lastStep;
 		uint32_t lastStepCost;
+		// Time the next step waits for its walk slot after being due
+		uint32_t walkSlotDelay;
 		uint32_t baseSpeed;
 		int32_t varSpeed;
 		bool skillLoss;
 		bool lootDrop;
 		Direction direction;
 		ConditionList conditions;
+		int64_t conditionsCheckTime;
+		// Think time until the next periodic condition event, -1 without any
+		int32_t conditionsTickDelay;
+		// Think time skipped since the last walk, handed to the conditions on the next one
+		int32_t conditionsSkippedInterval;
 		LightInfo internalLight;
 
 		//summon variables
@@ -99,7 +99,8 @@ enum SpellGroup_t
 	SPELLGROUP_ATTACK = 1,
 	SPELLGROUP_HEALING = 2,
 	SPELLGROUP_SUPPORT = 3,
-	SPELLGROUP_SPECIAL = 4
+	SPELLGROUP_SPECIAL = 4,
+	SPELLGROUP_LAST = SPELLGROUP_SPECIAL
 };
 
 enum DatabaseEngine_t
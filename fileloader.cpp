@@ -22,6 +22,10 @@
 
 #include "fileloader.h"
 
+#ifndef WIN32
+#include <sys/mman.h>
+#endif
+
 FileLoader::FileLoader()
 {
 	m_file = NULL;
@@ -32,10 +36,10 @@ FileLoader::FileLoader()
 
 	//cache
 	m_use_cache = false;
+	m_cache_mapped = false;
+	m_cached_data = NULL;
 	m_cache_size = 0;
-	m_cache_index = NO_VALID_CACHE;
-	m_cache_offset = NO_VALID_CACHE;
-	memset(m_cached_data, 0, sizeof(m_cached_data));
+	m_cache_offset = 0;
 }
 
 FileLoader::~FileLoader()
@@ -48,8 +52,13 @@ FileLoader::~FileLoader()
 
 	NodeStruct::clearNet(m_root);
 	delete[] m_buffer;
-	for(int32_t i = 0; i < CACHE_BLOCKS; i++)
-		delete[] m_cached_data[i].data;
+
+#ifndef WIN32
+	if(m_cache_mapped)
+		munmap(m_cached_data, m_cache_size);
+	else
+#endif
+		delete[] m_cached_data;
 }
 
 bool FileLoader::openFile(const char* filename, const char* accept_identifier, bool write, bool caching /*= false*/)
@@ -95,10 +104,15 @@ bool FileLoader::openFile(const char* filename, const char* accept_identifier, b
 
 	if(caching)
 	{
-		m_use_cache = true;
 		fseek(m_file, 0, SEEK_END);
 		int32_t file_size = ftell(m_file);
-		m_cache_size = std::min(32768, std::max(file_size/20, 8192)) & ~0x1FFF;
+		if(file_size <= 0 || !loadCache(file_size))
+		{
+			fclose(m_file);
+			m_file = NULL;
+			m_lastError = ERROR_CACHE_ERROR;
+			return false;
+		}
 	}
 
 	if(!safeSeek(4))
@@ -118,6 +132,35 @@ bool FileLoader::openFile(const char* filename, const char* accept_identifier, b
 	return false;
 }
 
+bool FileLoader::loadCache(uint32_t size)
+{
+#ifndef WIN32
+	void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fileno(m_file), 0);
+	if(data != MAP_FAILED)
+	{
+		//the node tree is parsed front to back, let the kernel read ahead
+		madvise(data, size, MADV_SEQUENTIAL);
+		m_cached_data = (uint8_t*)data;
+		m_cache_mapped = true;
+	}
+	else
+#endif
+	{
+		m_cached_data = new uint8_t[size];
+		if(fseek(m_file, 0, SEEK_SET) || fread(m_cached_data, 1, size, m_file) != size)
+		{
+			delete[] m_cached_data;
+			m_cached_data = NULL;
+			return false;
+		}
+	}
+
+	m_cache_size = size;
+	m_cache_offset = 0;
+	m_use_cache = true;
+	return true;
+}
+
 bool FileLoader::parseNode(NODE node)
 {
 	int32_t byte, pos;
@@ -221,6 +264,23 @@ const uint8_t* FileLoader::getProps(const NODE node, uint32_t &size)
 {
 	if(node)
 	{
+		if(m_use_cache)
+		{
+			if(node->start + 2 + node->propsSize > m_cache_size)
+			{
+				m_lastError = ERROR_EOF;
+				return NULL;
+			}
+
+			//nothing to unescape, hand out the cached data directly
+			const uint8_t* data = m_cached_data + node->start + 2;
+			if(!memchr(data, ESCAPE_CHAR, node->propsSize))
+			{
+				size = node->propsSize;
+				return data;
+			}
+		}
+
 		if(node->propsSize >= m_buffer_size)
 		{
 			delete[] m_buffer;
@@ -329,26 +389,13 @@ inline bool FileLoader::readByte(int32_t &value)
 {
 	if(m_use_cache)
 	{
-		if(m_cache_index == NO_VALID_CACHE)
+		if(m_cache_offset >= m_cache_size)
 		{
-			m_lastError = ERROR_CACHE_ERROR;
+			m_lastError = ERROR_EOF;
 			return false;
 		}
 
-		if(m_cache_offset >= m_cached_data[m_cache_index].size)
-		{
-			int32_t pos = m_cache_offset + m_cached_data[m_cache_index].base;
-			int32_t tmp = getCacheBlock(pos);
-			if(tmp < 0)
-				return false;
-
-			m_cache_index = tmp;
-			m_cache_offset = pos - m_cached_data[m_cache_index].base;
-			if(m_cache_offset >= m_cached_data[m_cache_index].size)
-				return false;
-		}
-
-		value = m_cached_data[m_cache_index].data[m_cache_offset];
+		value = m_cached_data[m_cache_offset];
 		m_cache_offset++;
 		return true;
 	}
@@ -365,31 +412,14 @@ inline bool FileLoader::readBytes(uint8_t* buffer, uint32_t size, int32_t pos)
 {
 	if(m_use_cache)
 	{
-		//seek at pos
-		uint32_t reading, remain = size, bufferPos = 0;
-		do
+		if(pos < 0 || (uint32_t)pos + size > m_cache_size)
 		{
-			//prepare cache
-			uint32_t i = getCacheBlock(pos);
-			if(i == NO_VALID_CACHE)
-				return false;
-
-			m_cache_index = i;
-			m_cache_offset = pos - m_cached_data[i].base;
-
-			//get maximum read block size and calculate remaining bytes
-			reading = std::min(remain, m_cached_data[i].size - m_cache_offset);
-			remain = remain - reading;
-
-			//read it
-			memcpy(buffer + bufferPos, m_cached_data[m_cache_index].data + m_cache_offset, reading);
-
-			//update variables
-			m_cache_offset = m_cache_offset + reading;
-			bufferPos = bufferPos + reading;
-			pos = pos + reading;
+			m_lastError = ERROR_EOF;
+			return false;
 		}
-		while(remain > 0);
+
+		memcpy(buffer, m_cached_data + pos, size);
+		m_cache_offset = pos + size;
 		return true;
 	}
 
@@ -427,12 +457,13 @@ inline bool FileLoader::safeSeek(uint32_t pos)
 {
 	if(m_use_cache)
 	{
-		uint32_t i = getCacheBlock(pos);
-		if(i == NO_VALID_CACHE)
+		if(pos > m_cache_size)
+		{
+			m_lastError = ERROR_SEEK_ERROR;
 			return false;
+		}
 
-		m_cache_index = i;
-		m_cache_offset = pos - m_cached_data[i].base;
+		m_cache_offset = pos;
 	}
 	else if(fseek(m_file, pos, SEEK_SET))
 	{
@@ -447,13 +478,7 @@ inline bool FileLoader::safeTell(int32_t &pos)
 {
 	if(m_use_cache)
 	{
-		if(m_cache_index == NO_VALID_CACHE)
-		{
-			m_lastError = ERROR_CACHE_ERROR;
-			return false;
-		}
-
-		pos = m_cached_data[m_cache_index].base + m_cache_offset - 1;
+		pos = m_cache_offset - 1;
 		return true;
 	}
 
@@ -467,76 +492,3 @@ inline bool FileLoader::safeTell(int32_t &pos)
 	pos = pos - 1;
 	return true;
 }
-
-inline uint32_t FileLoader::getCacheBlock(uint32_t pos)
-{
-	bool found = false;
-	uint32_t i, base_pos = pos & ~(m_cache_size - 1);
-	for(i = 0; i < CACHE_BLOCKS; i++)
-	{
-		if(m_cached_data[i].loaded)
-		{
-			if(m_cached_data[i].base == base_pos)
-			{
-				found = true;
-				break;
-			}
-		}
-	}
-
-	if(!found)
-		i = loadCacheBlock(pos);
-
-	return i;
-}
-
-int32_t FileLoader::loadCacheBlock(uint32_t pos)
-{
-	int32_t i, loading_cache = -1, base_pos = pos & ~(m_cache_size - 1);
-	for(i = 0; i < CACHE_BLOCKS; i++)
-	{
-		if(!m_cached_data[i].loaded)
-		{
-			loading_cache = i;
-			break;
-		}
-	}
-
-	if(loading_cache == -1)
-	{
-		for(i = 0; i < CACHE_BLOCKS; i++)
-		{
-			if((long)(abs((long)m_cached_data[i].base - base_pos)) > (long)(2 * m_cache_size))
-			{
-				loading_cache = i;
-				break;
-			}
-		}
-
-		if(loading_cache == -1)
-			loading_cache = 0;
-	}
-
-	if(m_cached_data[loading_cache].data == NULL)
-		m_cached_data[loading_cache].data = new uint8_t[m_cache_size];
-
-	m_cached_data[loading_cache].base = base_pos;
-
-	if(fseek(m_file, m_cached_data[loading_cache].base, SEEK_SET))
-	{
-		m_lastError = ERROR_SEEK_ERROR;
-		return -1;
-	}
-
-	uint32_t size = fread(m_cached_data[loading_cache].data, 1, m_cache_size, m_file);
-	m_cached_data[loading_cache].size = size;
-
-	if(size < (pos - m_cached_data[loading_cache].base))
-	{
-		m_lastError = ERROR_SEEK_ERROR;
-		return -1;
-	}
-
-	m_cached_data[loading_cache].loaded = 1;
-	return loading_cache;
-}
@@ -168,23 +168,13 @@ class FileLoader
 		uint32_t m_buffer_size;
 		uint8_t* m_buffer;
 
+		//with caching the whole file is kept in memory (mapped where possible)
 		bool m_use_cache;
-		struct _cache
-		{
-			uint32_t loaded;
-			uint32_t base;
-			uint32_t size;
-			uint8_t* data;
-		};
-
-		#define CACHE_BLOCKS 3
+		bool m_cache_mapped;
+		uint8_t* m_cached_data;
 		uint32_t m_cache_size;
-		_cache m_cached_data[CACHE_BLOCKS];
-		#define NO_VALID_CACHE 0xFFFFFFFF
-		uint32_t m_cache_index;
 		uint32_t m_cache_offset;
-		inline uint32_t getCacheBlock(uint32_t pos);
-		int32_t loadCacheBlock(uint32_t pos);
+		bool loadCache(uint32_t size);
 };
 
 class PropStream
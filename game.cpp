@@ -56,6 +56,7 @@
 #include "globalevent.h"
 #include "mounts.h"
 #include "beds.h"
+#include "combatlog.h"
 
 extern ConfigManager g_config;
 extern Actions* g_actions;
@@ -92,6 +93,11 @@ Game::Game()
 
 	lastBucket = 0;
 
+	checkCreatureLastRun = 0;
+	checkCreatureOverload = false;
+	for(int32_t i = 0; i < EVENT_CREATURECOUNT; ++i)
+		checkCreatureBucketSize[i] = 0;
+
 	//(1440 minutes/day)/(3600 seconds/day)*10 seconds event interval
 	int32_t dayCycle = 3600;
 	lightHourDelta = 1440 * 10 / dayCycle;
@@ -260,13 +266,46 @@ int32_t Game::loadMap(const std::string& filename)
 	if(!map)
 		map = new Map;
 
+	loadMapSettings();
+	return map->loadMap("data/world/" + filename + ".otbm");
+}
+
+void Game::loadMapSettings()
+{
 	inFightTicks = g_config.getNumber(ConfigManager::PZ_LOCKED);
 	Player::maxMessageBuffer = g_config.getNumber(ConfigManager::MAX_MESSAGEBUFFER);
 	Monster::despawnRange = g_config.getNumber(ConfigManager::DEFAULT_DESPAWNRANGE);
 	Monster::despawnRadius = g_config.getNumber(ConfigManager::DEFAULT_DESPAWNRADIUS);
-	return map->loadMap("data/world/" + filename + ".otbm");
 }
 
+#ifdef __COMBAT_BENCH__
+bool Game::loadArenaMap(const Position& origin, uint16_t width, uint16_t height, uint16_t groundId)
+{
+	if(!map)
+		map = new Map;
+
+	loadMapSettings();
+	for(uint16_t x = origin.x; x < origin.x + width; ++x)
+	{
+		for(uint16_t y = origin.y; y < origin.y + height; ++y)
+		{
+			Item* ground = Item::CreateItem(groundId);
+			if(!ground)
+				return false;
+
+			//ground only, the same compact tile the map loader uses for it
+			Tile* tile = new StaticTile(x, y, origin.z);
+			tile->__internalAddThing(ground);
+			map->setTile(x, y, origin.z, tile);
+		}
+	}
+
+	map->mapWidth = origin.x + width;
+	map->mapHeight = origin.y + height;
+	return true;
+}
+#endif
+
 void Game::refreshMap()
 {
 	Tile* tile;
@@ -710,6 +749,7 @@ bool Game::placeCreature(Creature* creature, const Position& pos, bool extendedP
 		if(conditionMuted && conditionMuted->getTicks() > 0)
 		{
 			conditionMuted->setTicks(conditionMuted->getTicks() - (offlineTime * 1000));
+			player->invalidateConditionsCheck();
 			if(conditionMuted->getTicks() <= 0)
 				player->removeCondition(conditionMuted);
 			else
@@ -720,6 +760,7 @@ bool Game::placeCreature(Creature* creature, const Position& pos, bool extendedP
 		if(conditionTrade && conditionTrade->getTicks() > 0)
 		{
 			conditionTrade->setTicks(conditionTrade->getTicks() - (offlineTime * 1000));
+			player->invalidateConditionsCheck();
 			if(conditionTrade->getTicks() <= 0)
 				player->removeCondition(conditionTrade);
 			else
@@ -730,6 +771,7 @@ bool Game::placeCreature(Creature* creature, const Position& pos, bool extendedP
 		if(conditionYell && conditionYell->getTicks() > 0)
 		{
 			conditionYell->setTicks(conditionYell->getTicks() - (offlineTime * 1000));
+			player->invalidateConditionsCheck();
 			if(conditionYell->getTicks() <= 0)
 				player->removeCondition(conditionYell);
 			else
@@ -4150,6 +4192,49 @@ void Game::checkCreatureWalk(uint32_t creatureId)
 	}
 }
 
+uint32_t Game::addCreatureWalk(Creature* creature, int64_t delay)
+{
+	int64_t now = OTSYS_TIME();
+
+	//round up, a step must never run before its walk delay has passed
+	int64_t slotTime = now + delay + EVENT_WALK_SLOT_INTERVAL - 1;
+	slotTime -= slotTime % EVENT_WALK_SLOT_INTERVAL;
+
+	WalkSlot& walkSlot = walkSlots[slotTime];
+	if(walkSlot.eventId == 0)
+	{
+		walkSlot.eventId = g_scheduler.addEvent(createSchedulerTask(slotTime - now,
+			boost::bind(&Game::checkCreatureWalks, this, slotTime)));
+	}
+
+	walkSlot.creatures.push_back(creature->getID());
+	creature->walkSlotDelay = slotTime - (now + delay);
+	return walkSlot.eventId;
+}
+
+void Game::checkCreatureWalks(int64_t slotTime)
+{
+	WalkSlotMap::iterator it = walkSlots.find(slotTime);
+	if(it == walkSlots.end())
+		return;
+
+	uint32_t eventId = it->second.eventId;
+	std::vector<uint32_t> creatures;
+	creatures.swap(it->second.creatures);
+	walkSlots.erase(it);
+
+	//all steps of the slot run in one task, so spectators get their moves in one flush
+	for(std::vector<uint32_t>::const_iterator cit = creatures.begin(), end = creatures.end(); cit != end; ++cit)
+	{
+		Creature* creature = getCreatureByID(*cit);
+		//creatures that stopped or rescheduled their walk meanwhile hold another event id
+		if(creature && creature->eventWalk == eventId && creature->getHealth() > 0)
+			creature->onWalk();
+	}
+
+	cleanup();
+}
+
 void Game::updateCreatureWalk(uint32_t creatureId)
 {
 	Creature* creature = getCreatureByID(creatureId);
@@ -4173,8 +4258,18 @@ void Game::addCreatureCheck(Creature* creature)
 	if(creature->checkCreatureVectorIndex >= 0)
 		return; //Already in a vector
 
+	//keep the buckets evenly sized so each check does a similar amount of work
+	int32_t index = 0;
+	for(int32_t i = 1; i < EVENT_CREATURECOUNT; ++i)
+	{
+		if(checkCreatureBucketSize[i] < checkCreatureBucketSize[index])
+			index = i;
+	}
+
 	toAddCheckCreatureVector.push_back(creature);
-	creature->checkCreatureVectorIndex = random_range(0, EVENT_CREATURECOUNT - 1);
+	creature->checkCreatureVectorIndex = index;
+	creature->checkCreatureDeferredTicks = 0;
+	++checkCreatureBucketSize[index];
 	creature->useThing2();
 }
 
@@ -4186,9 +4281,40 @@ void Game::removeCreatureCheck(Creature* creature)
 	creature->creatureCheck = false;
 }
 
+void Game::addPendingStats(Player* player)
+{
+	//one flush task per batch, queued in front so it runs right after the task that changed the stats
+	if(pendingStatsPlayers.empty())
+		g_dispatcher.addTask(createTask(boost::bind(&Game::sendPendingStats, this)), true);
+
+	pendingStatsPlayers.push_back(player->getID());
+}
+
+void Game::sendPendingStats()
+{
+	std::vector<uint32_t> players;
+	players.swap(pendingStatsPlayers);
+	for(std::vector<uint32_t>::const_iterator it = players.begin(), end = players.end(); it != end; ++it)
+	{
+		if(Player* player = getPlayerByID(*it))
+			player->flushStats();
+	}
+}
+
 void Game::checkCreatures()
 {
 	checkCreatureEvent = g_scheduler.addEvent(createSchedulerTask(EVENT_CHECK_CREATURE_INTERVAL, boost::bind(&Game::checkCreatures, this)));
+	checkCreatureBucket();
+}
+
+void Game::checkCreatureBucket()
+{
+	int64_t startTime = OTSYS_TIME(), lag = 0;
+	if(checkCreatureLastRun != 0)
+		lag = std::max<int64_t>(0, startTime - checkCreatureLastRun - EVENT_CHECK_CREATURE_INTERVAL);
+
+	checkCreatureLastRun = startTime;
+	boost::system_time bucketStart = boost::get_system_time();
 
 	Creature* creature;
 	std::vector<Creature*>::iterator it;
@@ -4213,8 +4339,21 @@ void Game::checkCreatures()
 		{
 			if(creature->getHealth() > 0)
 			{
-				creature->onThink(EVENT_CREATURE_THINK_INTERVAL);
-				creature->onAttacking(EVENT_CREATURE_THINK_INTERVAL);
+				if(checkCreatureOverload && creature->checkCreatureDeferredTicks == 0 && canDeferCreatureCheck(creature))
+				{
+					//we are running behind, let monsters far from any player think every other round
+					creature->checkCreatureDeferredTicks = EVENT_CREATURE_THINK_INTERVAL;
+					++creatureCheckStats.deferred;
+				}
+				else
+				{
+					uint32_t interval = EVENT_CREATURE_THINK_INTERVAL + creature->checkCreatureDeferredTicks;
+					creature->checkCreatureDeferredTicks = 0;
+
+					creature->onThink(interval);
+					creature->onAttacking(interval);
+				}
+
 				creature->executeConditions(EVENT_CREATURE_THINK_INTERVAL);
 			}
 			else
@@ -4225,11 +4364,38 @@ void Game::checkCreatures()
 		else
 		{
 			creature->checkCreatureVectorIndex = -1;
+			--checkCreatureBucketSize[checkCreatureLastIndex];
 			it = checkCreatureVector.erase(it);
 			FreeThing(creature);
 		}
 	}
 	cleanup();
+
+	//the bucket itself is timed with the boost clock, OTSYS_TIME is too coarse for it
+	int64_t duration = (boost::get_system_time() - bucketStart).total_microseconds();
+	checkCreatureOverload = (lag * 1000 + duration > EVENT_CHECK_CREATURE_INTERVAL * 1000);
+
+	++creatureCheckStats.buckets;
+	if(checkCreatureOverload)
+		++creatureCheckStats.overloaded;
+
+	creatureCheckStats.lastLag = lag;
+	creatureCheckStats.maxLag = std::max(creatureCheckStats.maxLag, lag);
+	creatureCheckStats.lastDuration = duration;
+	creatureCheckStats.maxDuration = std::max(creatureCheckStats.maxDuration, duration);
+}
+
+bool Game::canDeferCreatureCheck(Creature* creature)
+{
+	//only monsters without a master and without any player close by, so nothing near a player gets slower
+	Monster* monster = creature->getMonster();
+	if(!monster || monster->isSummon())
+		return false;
+
+	int32_t range = g_config.getNumber(ConfigManager::CREATURE_DEFER_RANGE);
+	SpectatorVec list;
+	getSpectators(list, monster->getPosition(), false, true, range, range, range, range);
+	return list.empty();
 }
 
 void Game::changeSpeed(Creature* creature, int32_t varSpeedDelta)
@@ -4355,6 +4521,9 @@ bool Game::combatBlockHit(CombatType_t combatType, Creature* attacker, Creature*
 
 bool Game::combatChangeHealth(CombatType_t combatType, Creature* attacker, Creature* target, int32_t healthChange)
 {
+	if(CombatLog::isEnabled())
+		CombatLog::getInstance()->record(attacker, target, combatType, healthChange, false);
+
 	const Position& targetPos = target->getPosition();
 	if(healthChange > 0)
 	{
@@ -4674,6 +4843,9 @@ bool Game::combatChangeHealth(CombatType_t combatType, Creature* attacker, Creat
 
 bool Game::combatChangeMana(Creature* attacker, Creature* target, int32_t manaChange)
 {
+	if(CombatLog::isEnabled())
+		CombatLog::getInstance()->record(attacker, target, COMBAT_MANADRAIN, manaChange, true);
+
 	if(manaChange > 0)
 	{
 		if(attacker)
@@ -4990,6 +5162,7 @@ void Game::shutdown()
 
 	g_scheduler.shutdown();
 	g_dispatcher.shutdown();
+	CombatLog::getInstance()->stop();
 	Spawns::getInstance()->clear();
 	Raids::getInstance()->clear();
 
@@ -5008,6 +5181,11 @@ void Game::cleanup()
 		(*it)->releaseThing2();
 
 	ToReleaseThings.clear();
+	//a tile may empty again before cleanup, releasing twice is harmless
+	for(std::vector<StaticTile*>::iterator it = ToReleaseItemLists.begin(); it != ToReleaseItemLists.end(); ++it)
+		(*it)->releaseEmptyItemList();
+
+	ToReleaseItemLists.clear();
 	for(DecayList::iterator it = toDecayItems.begin(); it != toDecayItems.end(); ++it)
 	{
 		int32_t dur = (*it)->getDuration();
@@ -5025,6 +5203,11 @@ void Game::FreeThing(Thing* thing)
 	ToReleaseThings.push_back(thing);
 }
 
+void Game::FreeTileItemList(Tile* tile)
+{
+	ToReleaseItemLists.push_back(static_cast<StaticTile*>(tile));
+}
+
 bool Game::broadcastMessage(const std::string& text, MessageClasses type)
 {
 	std::cout << "> Broadcasted message: \"" << text << "\"." << std::endl;
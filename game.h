@@ -87,6 +87,16 @@ enum LightState_t
 typedef std::map<int32_t, int32_t> StageList;
 typedef std::vector<std::string> StatusList;
 
+struct CreatureCheckStats
+{
+	CreatureCheckStats() : buckets(0), overloaded(0), deferred(0), lastLag(0), maxLag(0),
+		lastDuration(0), maxDuration(0) {}
+
+	uint64_t buckets, overloaded, deferred;
+	int64_t lastLag, maxLag;
+	int64_t lastDuration, maxDuration; //microseconds
+};
+
 /**
   * Main Game class.
   * This class is responsible to control everything that happens
@@ -114,6 +124,18 @@ class Game
 		  */
 		int32_t loadMap(const std::string& filename);
 
+#ifdef __COMBAT_BENCH__
+		/**
+		  * Create a flat map instead of loading one, used by the combat benchmark.
+		  * \param origin Top left tile of the arena
+		  * \param width Number of tiles along x
+		  * \param height Number of tiles along y
+		  * \param groundId Item id of the ground on every tile
+		  * \returns true if every tile could be created
+		  */
+		bool loadArenaMap(const Position& origin, uint16_t width, uint16_t height, uint16_t groundId);
+#endif
+
 		/**
 		  * Get the map size - info purpose only
 		  * \param width width of the map
@@ -248,6 +270,12 @@ class Game
 		void addCreatureCheck(Creature* creature);
 		void removeCreatureCheck(Creature* creature);
 
+		void addPendingStats(Player* player);
+		void sendPendingStats();
+
+		const CreatureCheckStats& getCreatureCheckStats() const {return creatureCheckStats;}
+		uint32_t getCreatureCheckBucketSize(size_t index) const {return checkCreatureBucketSize[index];}
+
 		uint32_t getPlayersOnline() {return (uint32_t)Player::listPlayer.list.size();}
 		uint32_t getMonstersOnline() {return (uint32_t)Monster::listMonster.list.size();}
 		uint32_t getNpcsOnline() {return (uint32_t)Npc::listNpc.list.size();}
@@ -471,6 +499,7 @@ class Game
 		void cleanup();
 		void shutdown();
 		void FreeThing(Thing* thing);
+		void FreeTileItemList(Tile* tile);
 
 		bool canThrowObjectTo(const Position& fromPos, const Position& toPos, bool checkLineOfSight = true,
 			int32_t rangex = Map::maxClientViewportX, int32_t rangey = Map::maxClientViewportY);
@@ -504,11 +533,16 @@ class Game
 
 		//Events
 		void checkCreatureWalk(uint32_t creatureId);
+		uint32_t addCreatureWalk(Creature* creature, int64_t delay);
+		void checkCreatureWalks(int64_t slotTime);
 		void updateCreatureWalk(uint32_t creatureId);
 		void checkCreatureAttack(uint32_t creatureId);
 		void checkCreatures();
 		void checkLight();
 
+		//runs the next creature check bucket without scheduling another round
+		void checkCreatureBucket();
+
 		bool combatBlockHit(CombatType_t combatType, Creature* attacker, Creature* target,
 			int32_t& healthChange, bool checkDefense, bool checkArmor);
 
@@ -550,6 +584,8 @@ class Game
 		bool isInWhitelist(const std::string& ip) const { for (StatusList::const_iterator it = whitelist.begin(), end = whitelist.end(); it != end; ++it) { if (*it == ip) return true; } return false; }
 
 	protected:
+		void loadMapSettings();
+
 		bool playerSayCommand(Player* player, SpeakClasses type, const std::string& text);
 		bool playerSaySpell(Player* player, SpeakClasses type, const std::string& text);
 		bool playerWhisper(Player* player, const std::string& text);
@@ -562,6 +598,7 @@ class Game
 		int64_t stateTime;
 
 		std::vector<Thing*> ToReleaseThings;
+		std::vector<StaticTile*> ToReleaseItemLists;
 
 		uint32_t checkLightEvent;
 		uint32_t checkCreatureEvent;
@@ -575,6 +612,26 @@ class Game
 		size_t checkCreatureLastIndex;
 		std::vector<Creature*> checkCreatureVectors[EVENT_CREATURECOUNT];
 		std::vector<Creature*> toAddCheckCreatureVector;
+		uint32_t checkCreatureBucketSize[EVENT_CREATURECOUNT];
+		int64_t checkCreatureLastRun;
+		bool checkCreatureOverload;
+		CreatureCheckStats creatureCheckStats;
+
+		bool canDeferCreatureCheck(Creature* creature);
+
+		//walk steps due within the same EVENT_WALK_SLOT_INTERVAL share one scheduler event
+		struct WalkSlot
+		{
+			WalkSlot() : eventId(0) {}
+
+			uint32_t eventId;
+			std::vector<uint32_t> creatures;
+		};
+
+		typedef std::map<int64_t, WalkSlot> WalkSlotMap;
+		WalkSlotMap walkSlots;
+
+		std::vector<uint32_t> pendingStatsPlayers;
 
 		struct GameEvent
 		{
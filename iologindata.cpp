@@ -392,10 +392,29 @@ bool IOLoginData::loadPlayer(Player* player, const std::string& name, bool prelo
 	Condition* condition;
 	while((condition = Condition::createCondition(propStream)))
 	{
-		if(condition->unserialize(propStream))
-			player->storedConditionList.push_back(condition);
-		else
+		if(!condition->unserialize(propStream))
+		{
+			delete condition;
+			continue;
+		}
+
+		//cooldowns are kept in the player's cooldown table, not as conditions
+		if(condition->getType() == CONDITION_SPELLCOOLDOWN)
+		{
+			if(condition->getTicks() > 0)
+				player->spellCooldowns[(uint8_t)condition->getSubId()] = OTSYS_TIME() + condition->getTicks();
+
 			delete condition;
+		}
+		else if(condition->getType() == CONDITION_SPELLGROUPCOOLDOWN)
+		{
+			if(condition->getTicks() > 0 && condition->getSubId() <= SPELLGROUP_LAST)
+				player->spellGroupCooldowns[condition->getSubId()] = OTSYS_TIME() + condition->getTicks();
+
+			delete condition;
+		}
+		else
+			player->storedConditionList.push_back(condition);
 	}
 
 	player->setVocation(result->getDataInt("vocation"));
@@ -438,7 +457,7 @@ bool IOLoginData::loadPlayer(Player* player, const std::string& name, bool prelo
 		if(skullSeconds > 0)
 		{
 			//ensure that we round up the number of ticks
-			player->skullTicks = (skullSeconds + 2) * 1000;
+			player->skullEndTime = OTSYS_TIME() + (skullSeconds + 2) * 1000;
 			int32_t skull = result->getDataInt("skull");
 			if(skull == SKULL_RED)
 				player->skull = SKULL_RED;
@@ -681,6 +700,7 @@ bool IOLoginData::loadPlayer(Player* player, const std::string& name, bool prelo
 
 	player->updateBaseSpeed();
 	player->updateInventoryWeight();
+	player->updateInventoryArmor();
 	player->updateItemsLight(true);
 	return true;
 }
@@ -782,6 +802,36 @@ bool IOLoginData::savePlayer(Player* player)
 		}
 	}
 
+	//store running cooldowns in the same format as the conditions they replaced
+	int64_t timeNow = OTSYS_TIME();
+	std::list<Condition*> cooldownList;
+	for(int32_t i = 0; i < 256; ++i)
+	{
+		if(player->spellCooldowns[i] > timeNow)
+			cooldownList.push_back(Condition::createCondition(CONDITIONID_DEFAULT, CONDITION_SPELLCOOLDOWN, player->spellCooldowns[i] - timeNow, 0, false, i));
+	}
+
+	for(int32_t i = SPELLGROUP_NONE; i <= SPELLGROUP_LAST; ++i)
+	{
+		if(player->spellGroupCooldowns[i] > timeNow)
+			cooldownList.push_back(Condition::createCondition(CONDITIONID_DEFAULT, CONDITION_SPELLGROUPCOOLDOWN, player->spellGroupCooldowns[i] - timeNow, 0, false, i));
+	}
+
+	bool cooldownsSaved = true;
+	for(std::list<Condition*>::iterator it = cooldownList.begin(); it != cooldownList.end(); ++it)
+	{
+		if(cooldownsSaved)
+		{
+			cooldownsSaved = (*it)->serialize(propWriteStream);
+			if(cooldownsSaved)
+				propWriteStream.ADD_UCHAR(CONDITIONATTR_END);
+		}
+		delete *it;
+	}
+
+	if(!cooldownsSaved)
+		return false;
+
 	uint32_t conditionsSize = 0;
 	const char* conditions = propWriteStream.getStream(conditionsSize);
 
@@ -826,8 +876,9 @@ bool IOLoginData::savePlayer(Player* player)
 	if(g_game.getWorldType() != WORLD_TYPE_PVP_ENFORCED)
 	{
 		int32_t skullTime = 0;
-		if(player->skullTicks > 0)
-			skullTime = time(NULL) + player->skullTicks / 1000;
+		int64_t skullTicks = player->getSkullTicks();
+		if(skullTicks > 0)
+			skullTime = time(NULL) + skullTicks / 1000;
 
 		query << "`skulltime` = " << skullTime << ", ";
 		int32_t skull = 0;
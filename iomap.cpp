@@ -66,7 +66,8 @@ Tile* IOMap::createTile(Item*& ground, Item* item, int px, int py, int pz)
 	Tile* tile;
 	if(ground)
 	{
-		if((item && item->isBlocking()) || ground->isBlocking())
+		//tiles holding nothing but ground keep the compact layout until something is put on them
+		if(!item || item->isBlocking() || ground->isBlocking())
 			tile = new StaticTile(px, py, pz);
 		else
 			tile = new DynamicTile(px, py, pz);
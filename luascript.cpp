@@ -568,6 +568,10 @@ std::string LuaScriptInterface::getErrorDesc(ErrorCode_t code)
 ScriptEnvironment LuaScriptInterface::m_scriptEnv[16];
 int32_t LuaScriptInterface::m_scriptEnvIndex = -1;
 
+#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+uint64_t LuaScriptInterface::callCount = 0;
+#endif
+
 LuaScriptInterface::LuaScriptInterface(const std::string& interfaceName)
 {
 	m_luaState = NULL;
@@ -592,6 +596,10 @@ bool LuaScriptInterface::reInitState()
 /// Same as lua_pcall, but adds stack trace to error strings in called function.
 int32_t LuaScriptInterface::protectedCall(lua_State* L, int32_t nargs, int32_t nresults)
 {
+	#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+	callCount++;
+	#endif
+
 	int error_index = lua_gettop(L) - nargs;
 	lua_pushcfunction(L, luaErrorHandler);
 	lua_insert(L, error_index);
@@ -309,6 +309,10 @@ class LuaScriptInterface
 		static int32_t luaErrorHandler(lua_State* L);
 		bool callFunction(uint32_t nParams);
 
+#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+		static uint64_t callCount;
+#endif
+
 		//push/pop common structures
 		static void pushThing(lua_State* L, Thing* thing, uint32_t thingid);
 		static void pushVariant(lua_State* L, const LuaVariant& var);
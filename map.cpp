@@ -50,6 +50,11 @@ extern Game g_game;
 extern ConfigManager g_config;
 IOMapSerialize IOMapSerialize;
 
+#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+uint64_t Map::spectatorQueries = 0;
+uint64_t Map::spectatorScans = 0;
+#endif
+
 Map::Map()
 {
 	mapWidth = 0;
@@ -169,6 +174,7 @@ void Map::setTile(int32_t x, int32_t y, int32_t z, Tile* newTile)
 	if(!floor->tiles[offsetX][offsetY])
 	{
 		floor->tiles[offsetX][offsetY] = newTile;
+		floor->setBlockingProjectile(offsetX, offsetY, newTile->hasFlag(TILESTATE_BLOCKPROJECTILE));
 		newTile->qt_node = leaf;
 	}
 	else
@@ -299,6 +305,10 @@ bool Map::removeCreature(Creature* creature)
 
 void Map::getSpectatorsInternal(SpectatorVec& list, const Position& centerPos, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY, int32_t minRangeZ, int32_t maxRangeZ, bool onlyPlayers)
 {
+	#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+	spectatorScans++;
+	#endif
+
 	int32_t minoffset = centerPos.z - maxRangeZ;
 	int32_t x1 = std::min<int32_t>(0xFFFF, std::max<int32_t>(0, (centerPos.x + minRangeX + minoffset)));
 	int32_t y1 = std::min<int32_t>(0xFFFF, std::max<int32_t>(0, (centerPos.y + minRangeY + minoffset)));
@@ -372,6 +382,10 @@ void Map::getSpectators(SpectatorVec& list, const Position& centerPos, bool mult
 	int32_t minRangeX /*= 0*/, int32_t maxRangeX /*= 0*/,
 	int32_t minRangeY /*= 0*/, int32_t maxRangeY /*= 0*/)
 {
+	#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+	spectatorQueries++;
+	#endif
+
 	if(centerPos.z >= MAP_MAX_LAYERS)
 		return;
 
@@ -460,6 +474,10 @@ void Map::getSpectators(SpectatorVec& list, const Position& centerPos, bool mult
 
 const SpectatorVec& Map::getSpectators(const Position& centerPos)
 {
+	#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+	spectatorQueries++;
+	#endif
+
 	if(centerPos.z >= MAP_MAX_LAYERS)
 	{
 		boost::shared_ptr<SpectatorVec> p(new SpectatorVec());
@@ -556,6 +574,11 @@ bool Map::checkSightLine(const Position& fromPos, const Position& toPos) const
 	int32_t B = start.x - destination.x;
 	int32_t C = -(A*destination.x + B*destination.y);
 
+	//the floor is only looked up again when the line leaves the current 8x8 block
+	QTreeNode* rootNode = const_cast<QTreeNode*>(&root);
+	const Floor* floor = NULL;
+	int32_t floorX = -1, floorY = -1;
+
 	while(!Position::areInRange<0,0,15>(start, destination))
 	{
 		int32_t move_hor = std::abs(A * (start.x + mx) + B * (start.y) + C);
@@ -568,12 +591,91 @@ bool Map::checkSightLine(const Position& fromPos, const Position& toPos) const
 		if(start.x != destination.x && (start.y == destination.y || move_ver > move_hor || move_ver > move_cross))
 			start.x += mx;
 
-		const Tile* tile = const_cast<Map*>(this)->getTile(start.x, start.y, start.z);
-		if(tile && tile->hasProperty(BLOCKPROJECTILE))
+		if((start.x & ~FLOOR_MASK) != floorX || (start.y & ~FLOOR_MASK) != floorY)
+		{
+			floorX = start.x & ~FLOOR_MASK;
+			floorY = start.y & ~FLOOR_MASK;
+
+			QTreeLeafNode* leaf = QTreeNode::getLeafStatic(rootNode, start.x, start.y);
+			floor = (leaf ? leaf->getFloor(start.z) : NULL);
+		}
+
+		if(floor && floor->isBlockingProjectile(start.x, start.y))
+		{
+#ifdef __DEBUG__
+			assert(!checkSightLineSlow(fromPos, toPos));
+#endif
 			return false;
+		}
 	}
 
 	// now we need to perform a jump between floors to see if everything is clear (literally)
+	while(start.z != destination.z)
+	{
+		const Tile* tile = const_cast<Map*>(this)->getTile(start.x, start.y, start.z);
+		if(tile && tile->getThingCount() > 0)
+		{
+#ifdef __DEBUG__
+			assert(!checkSightLineSlow(fromPos, toPos));
+#endif
+			return false;
+		}
+
+		start.z++;
+	}
+
+#ifdef __DEBUG__
+	assert(checkSightLineSlow(fromPos, toPos));
+#endif
+	return true;
+}
+
+#if defined(__DEBUG__) || defined(__COMBAT_BENCH__)
+bool Map::checkSightLineSlow(const Position& fromPos, const Position& toPos) const
+{
+	if(fromPos == toPos)
+		return true;
+
+	Position start(fromPos.z > toPos.z ? toPos : fromPos);
+	Position destination(fromPos.z > toPos.z ? fromPos : toPos);
+
+	const int8_t mx = start.x < destination.x ? 1 : start.x == destination.x ? 0 : -1;
+	const int8_t my = start.y < destination.y ? 1 : start.y == destination.y ? 0 : -1;
+
+	int32_t A = destination.y - start.y;
+	int32_t B = start.x - destination.x;
+	int32_t C = -(A*destination.x + B*destination.y);
+
+	while(!Position::areInRange<0,0,15>(start, destination))
+	{
+		int32_t move_hor = std::abs(A * (start.x + mx) + B * (start.y) + C);
+		int32_t move_ver = std::abs(A * (start.x) + B * (start.y + my) + C);
+		int32_t move_cross = std::abs(A * (start.x + mx) + B * (start.y + my) + C);
+
+		if(start.y != destination.y && (start.x == destination.x || move_hor > move_ver || move_hor > move_cross))
+			start.y += my;
+
+		if(start.x != destination.x && (start.y == destination.y || move_ver > move_hor || move_ver > move_cross))
+			start.x += mx;
+
+		//the items themselves, Tile::hasProperty answers from the flags that feed the bitmap
+		const Tile* tile = const_cast<Map*>(this)->getTile(start.x, start.y, start.z);
+		if(!tile)
+			continue;
+
+		if(tile->ground && tile->ground->hasProperty(BLOCKPROJECTILE))
+			return false;
+
+		if(const TileItemVector* items = tile->getItemList())
+		{
+			for(ItemVector::const_iterator it = items->begin(); it != items->end(); ++it)
+			{
+				if((*it)->hasProperty(BLOCKPROJECTILE))
+					return false;
+			}
+		}
+	}
+
 	while(start.z != destination.z)
 	{
 		const Tile* tile = const_cast<Map*>(this)->getTile(start.x, start.y, start.z);
@@ -584,6 +686,7 @@ bool Map::checkSightLine(const Position& fromPos, const Position& toPos) const
 	}
 	return true;
 }
+#endif
 
 bool Map::isSightClear(const Position& fromPos, const Position& toPos, bool floorCheck) const
 {
@@ -1101,6 +1204,7 @@ int32_t AStarNodes::getEstimatedDistance(int32_t x, int32_t y, int32_t xGoal, in
 
 Floor::Floor()
 {
+	blockProjectile = 0;
 	for(uint32_t i = 0; i < FLOOR_SIZE; ++i)
 	{
 		for(uint32_t j = 0; j < FLOOR_SIZE; ++j)
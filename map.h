@@ -97,10 +97,24 @@ typedef std::map<Position, boost::shared_ptr<SpectatorVec> > SpectatorCache;
 #define FLOOR_SIZE (1 << FLOOR_BITS)
 #define FLOOR_MASK (FLOOR_SIZE - 1)
 
+#define FLOOR_BIT(x, y) ((uint64_t)1 << ((((x) & FLOOR_MASK) << FLOOR_BITS) | ((y) & FLOOR_MASK)))
+
 struct Floor
 {
 	Floor();
 	Tile* tiles[FLOOR_SIZE][FLOOR_SIZE];
+
+	// one bit per tile, set if anything on the tile blocks projectiles
+	uint64_t blockProjectile;
+
+	bool isBlockingProjectile(uint32_t x, uint32_t y) const {return (blockProjectile & FLOOR_BIT(x, y)) != 0;}
+	void setBlockingProjectile(uint32_t x, uint32_t y, bool blocking)
+	{
+		if(blocking)
+			blockProjectile |= FLOOR_BIT(x, y);
+		else
+			blockProjectile &= ~FLOOR_BIT(x, y);
+	}
 };
 
 class FrozenPathingConditionCall;
@@ -167,6 +181,11 @@ class Map
 		static const int32_t maxClientViewportX = 8;
 		static const int32_t maxClientViewportY = 6;
 
+#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+		static uint64_t spectatorQueries;
+		static uint64_t spectatorScans;
+#endif
+
 		/**
 		  * Load a map.
 		  * \returns true if the map was loaded successfully
@@ -238,6 +257,11 @@ class Map
 		  */
 		bool isSightClear(const Position& fromPos, const Position& toPos, bool floorCheck) const;
 		bool checkSightLine(const Position& fromPos, const Position& toPos) const;
+#if defined(__DEBUG__) || defined(__COMBAT_BENCH__)
+		// The line walk from before the projectile bitmap, it reads the items of every tile
+		// and is only kept as the reference checkSightLine is compared against
+		bool checkSightLineSlow(const Position& fromPos, const Position& toPos) const;
+#endif
 
 		const Tile* canWalkTo(const Creature* creature, const Position& pos);
 
@@ -30,6 +30,7 @@
 #include "combat.h"
 #include "spawn.h"
 #include "configmanager.h"
+#include "combatlog.h"
 
 extern Game g_game;
 extern ConfigManager g_config;
@@ -42,6 +43,8 @@ int32_t Monster::despawnRadius;
 
 #ifdef __ENABLE_SERVER_DIAGNOSTIC__
 uint32_t Monster::monsterCount = 0;
+uint64_t Monster::behaviorThinks = 0;
+uint64_t Monster::behaviorTime = 0;
 #endif
 
 Monster* Monster::createMonster(MonsterType* mType)
@@ -63,6 +66,7 @@ Creature()
 {
 	isIdle = true;
 	isMasterInRange = false;
+	targetListSteps = 0;
 	mType = _mtype;
 	spawn = NULL;
 	defaultOutfit = mType->outfit;
@@ -170,7 +174,14 @@ void Monster::onCreatureMove(const Creature* creature, const Tile* newTile, cons
 		if(isSummon())
 			isMasterInRange = canSee(getMaster()->getPosition());
 
-		updateTargetList();
+		//creatures moving inside our view keep the lists up to date through
+		//onCreatureEnter/onCreatureLeave, so a step only needs to look at the new edge.
+		//party, flag and master changes are not reported to us, a periodic full scan picks them up
+		if(teleport || isIdle || ++targetListSteps >= MONSTER_TARGETLIST_RESCAN_STEPS)
+			updateTargetList();
+		else
+			updateTargetList(oldPos);
+
 		updateIdleStatus();
 	}
 	else
@@ -198,11 +209,37 @@ void Monster::onCreatureMove(const Creature* creature, const Tile* newTile, cons
 }
 
 void Monster::updateTargetList()
+{
+	targetListSteps = 0;
+	pruneTargetList();
+
+	const SpectatorVec& list = g_game.getSpectators(getPosition());
+	for(SpectatorVec::const_iterator list_it = list.begin(), list_end = list.end(); list_it != list_end; ++list_it)
+	{
+		if((*list_it) != this && canSee((*list_it)->getPosition()))
+			onCreatureFound(*list_it);
+	}
+}
+
+void Monster::updateTargetList(const Position& oldPos)
+{
+	pruneTargetList();
+
+	const SpectatorVec& list = g_game.getSpectators(getPosition());
+	for(SpectatorVec::const_iterator list_it = list.begin(), list_end = list.end(); list_it != list_end; ++list_it)
+	{
+		const Position& pos = (*list_it)->getPosition();
+		if((*list_it) != this && canSee(pos) && !Creature::canSee(oldPos, pos, Map::maxViewportX, Map::maxViewportY))
+			onCreatureFound(*list_it);
+	}
+}
+
+void Monster::pruneTargetList()
 {
 	CreatureHashSet::iterator friendIterator = friendList.begin();
 	while(friendIterator != friendList.end())
 	{
-		if((*friendIterator)->getHealth() <= 0 || !canSee((*friendIterator)->getPosition()))
+		if((*friendIterator)->getHealth() <= 0 || !canSee((*friendIterator)->getPosition()) || !isFriend(*friendIterator))
 		{
 			(*friendIterator)->releaseThing2();
 			friendIterator = friendList.erase(friendIterator);
@@ -214,7 +251,7 @@ void Monster::updateTargetList()
 	CreatureList::iterator targetIterator = targetList.begin();
 	while(targetIterator != targetList.end())
 	{
-		if((*targetIterator)->getHealth() <= 0 || !canSee((*targetIterator)->getPosition()))
+		if((*targetIterator)->getHealth() <= 0 || !canSee((*targetIterator)->getPosition()) || !isOpponent(*targetIterator))
 		{
 			(*targetIterator)->releaseThing2();
 			targetIterator = targetList.erase(targetIterator);
@@ -222,13 +259,6 @@ void Monster::updateTargetList()
 		else
 			++targetIterator;
 	}
-
-	const SpectatorVec& list = g_game.getSpectators(getPosition());
-	for(SpectatorVec::const_iterator list_it = list.begin(), list_end = list.end(); list_it != list_end; ++list_it)
-	{
-		if((*list_it) != this && canSee((*list_it)->getPosition()))
-			onCreatureFound(*list_it);
-	}
 }
 
 void Monster::clearTargetList()
@@ -375,7 +405,7 @@ bool Monster::searchTarget(TargetSearchType_t searchType /*= TARGETSEARCH_DEFAUL
 	std::cout << "Searching target... " << std::endl;
 #endif
 
-	std::list<Creature*> resultList;
+	CreatureVector resultList;
 	const Position& myPos = getPosition();
 	for(CreatureList::iterator it = targetList.begin(); it != targetList.end(); ++it)
 	{
@@ -392,7 +422,7 @@ bool Monster::searchTarget(TargetSearchType_t searchType /*= TARGETSEARCH_DEFAUL
 		{
 			Creature* target = NULL;
 			int32_t minRange = -1;
-			for(std::list<Creature*>::iterator it = resultList.begin(); it != resultList.end(); ++it)
+			for(CreatureVector::iterator it = resultList.begin(); it != resultList.end(); ++it)
 			{
 				const Position& pos = (*it)->getPosition();
 				if(minRange == -1 || std::max(std::abs(myPos.x - pos.x), std::abs(myPos.y - pos.y)) < minRange)
@@ -415,13 +445,11 @@ bool Monster::searchTarget(TargetSearchType_t searchType /*= TARGETSEARCH_DEFAUL
 		{
 			if(!resultList.empty())
 			{
-				uint32_t index = random_range(0, resultList.size() - 1);
-				CreatureList::iterator it = resultList.begin();
-				std::advance(it, index);
+				Creature* target = resultList[random_range(0, resultList.size() - 1)];
 #ifdef __DEBUG__
-				std::cout << "Selecting target " << (*it)->getName() << std::endl;
+				std::cout << "Selecting target " << target->getName() << std::endl;
 #endif
-				return selectTarget(*it);
+				return selectTarget(target);
 			}
 
 			if(searchType == TARGETSEARCH_ATTACKRANGE)
@@ -542,9 +570,16 @@ void Monster::setIdle(bool _idle)
 	if(isRemoved() || getHealth() <= 0)
 		return;
 
+	bool wasIdle = isIdle;
 	isIdle = _idle;
 	if(!isIdle)
+	{
 		g_game.addCreatureCheck(this);
+
+		//the lists were cleared while idle, pick up whoever is already around
+		if(wasIdle)
+			updateTargetList();
+	}
 	else
 	{
 		onIdleStatus();
@@ -636,9 +671,16 @@ void Monster::onThink(uint32_t interval)
 				}
 			}
 
+#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+			behaviorThinks++;
+			boost::system_time behaviorStart = boost::get_system_time();
+#endif
 			onThinkTarget(interval);
 			onThinkYell(interval);
 			onThinkDefense(interval);
+#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+			behaviorTime += (boost::get_system_time() - behaviorStart).total_microseconds();
+#endif
 		}
 	}
 }
@@ -661,7 +703,7 @@ void Monster::doAttacking(uint32_t interval)
 		bool inRange = false;
 		if(canUseSpell(myPos, targetPos, *it, interval, inRange))
 		{
-			if(it->chance >= (uint32_t)random_range(1, 100))
+			if(it->chance >= 100 || it->chance >= (uint32_t)random_range(1, 100))
 			{
 				if(updateLook)
 				{
@@ -671,6 +713,8 @@ void Monster::doAttacking(uint32_t interval)
 
 				minCombatValue = it->minCombatValue;
 				maxCombatValue = it->maxCombatValue;
+
+				CombatLogScope logScope(mType->combatLogSource, mType->name);
 				it->spell->castSpell(this, attackedCreature);
 				if(it->isMelee)
 					extraMeleeAttack = false;
@@ -701,12 +745,11 @@ bool Monster::canUseAttack(const Position& pos, const Creature* target) const
 {
 	if(isHostile())
 	{
+		//attackRange is the widest ranged attack of the type
 		const Position& targetPos = target->getPosition();
-		for(SpellList::iterator it = mType->spellAttackList.begin(); it != mType->spellAttackList.end(); ++it)
-		{
-			if(it->range != 0 && std::max(std::abs(pos.x - targetPos.x), std::abs(pos.y - targetPos.y)) <= (int32_t)it->range)
-				return g_game.isSightClear(pos, targetPos, true);
-		}
+		if(mType->attackRange != 0 && std::max(std::abs(pos.x - targetPos.x), std::abs(pos.y - targetPos.y)) <= (int32_t)mType->attackRange)
+			return g_game.isSightClear(pos, targetPos, true);
+
 		return false;
 	}
 	return true;
@@ -785,31 +828,12 @@ void Monster::onThinkDefense(uint32_t interval)
 	resetTicks = true;
 	defenseTicks += interval;
 
-	for(SpellList::iterator it = mType->spellDefenseList.begin(); it != mType->spellDefenseList.end(); ++it)
-	{
-		if(it->speed > defenseTicks)
-		{
-			resetTicks = false;
-			continue;
-		}
-
-		if(defenseTicks % it->speed >= interval)
-		{
-			//already used this spell for this round
-			continue;
-		}
-
-		if((it->chance >= (uint32_t)random_range(1, 100)))
-		{
-			minCombatValue = it->minCombatValue;
-			maxCombatValue = it->maxCombatValue;
-			it->spell->castSpell(this, this);
-		}
-	}
-
-	if(!isSummon() && (int32_t)summons.size() < mType->maxSummons)
+	//no defense is ready yet, the loop would only keep the ticks running
+	if(defenseTicks < mType->minDefenseSpeed)
+		resetTicks = false;
+	else
 	{
-		for(SummonList::iterator it = mType->summonList.begin(); it != mType->summonList.end(); ++it)
+		for(SpellList::iterator it = mType->spellDefenseList.begin(); it != mType->spellDefenseList.end(); ++it)
 		{
 			if(it->speed > defenseTicks)
 			{
@@ -817,29 +841,61 @@ void Monster::onThinkDefense(uint32_t interval)
 				continue;
 			}
 
-			if((int32_t)summons.size() >= mType->maxSummons)
-				continue;
-
 			if(defenseTicks % it->speed >= interval)
 			{
 				//already used this spell for this round
 				continue;
 			}
 
-			if((it->chance >= (uint32_t)random_range(1, 100)))
+			if(it->chance >= 100 || it->chance >= (uint32_t)random_range(1, 100))
 			{
-				Monster* summon = Monster::createMonster(it->name);
-				if(summon)
+				minCombatValue = it->minCombatValue;
+				maxCombatValue = it->maxCombatValue;
+
+				CombatLogScope logScope(mType->combatLogSource, mType->name);
+				it->spell->castSpell(this, this);
+			}
+		}
+	}
+
+	if(!isSummon() && (int32_t)summons.size() < mType->maxSummons)
+	{
+		if(defenseTicks < mType->minSummonSpeed)
+			resetTicks = false;
+		else
+		{
+			for(SummonList::iterator it = mType->summonList.begin(); it != mType->summonList.end(); ++it)
+			{
+				if(it->speed > defenseTicks)
+				{
+					resetTicks = false;
+					continue;
+				}
+
+				if((int32_t)summons.size() >= mType->maxSummons)
+					continue;
+
+				if(defenseTicks % it->speed >= interval)
 				{
-					const Position& summonPos = getPosition();
+					//already used this spell for this round
+					continue;
+				}
 
-					addSummon(summon);
-					if(!g_game.placeCreature(summon, summonPos))
-						removeSummon(summon);
-					else
+				if(it->chance >= 100 || it->chance >= (uint32_t)random_range(1, 100))
+				{
+					Monster* summon = Monster::createMonster(it->name);
+					if(summon)
 					{
-						g_game.addMagicEffect(getPosition(), NM_ME_MAGIC_ENERGY);
-						g_game.addMagicEffect(summon->getPosition(), NM_ME_TELEPORT);
+						const Position& summonPos = getPosition();
+
+						addSummon(summon);
+						if(!g_game.placeCreature(summon, summonPos))
+							removeSummon(summon);
+						else
+						{
+							g_game.addMagicEffect(getPosition(), NM_ME_MAGIC_ENERGY);
+							g_game.addMagicEffect(summon->getPosition(), NM_ME_TELEPORT);
+						}
 					}
 				}
 			}
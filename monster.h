@@ -32,6 +32,9 @@ class Spawn;
 typedef OTSERV_HASH_SET<Creature*> CreatureHashSet;
 typedef std::list<Creature*> CreatureList;
 
+//own steps between full target list rescans, catches creatures that became friends or opponents in view
+#define MONSTER_TARGETLIST_RESCAN_STEPS 8
+
 enum TargetSearchType_t
 {
 	TARGETSEARCH_DEFAULT,
@@ -48,6 +51,8 @@ class Monster : public Creature
 	public:
 #ifdef __ENABLE_SERVER_DIAGNOSTIC__
 		static uint32_t monsterCount;
+		static uint64_t behaviorThinks;
+		static uint64_t behaviorTime;
 #endif
 		static Monster* createMonster(MonsterType* mType);
 		static Monster* createMonster(const std::string& name);
@@ -136,6 +141,7 @@ class Monster : public Creature
 		int32_t targetChangeCooldown;
 		bool resetTicks;
 		bool isIdle;
+		uint32_t targetListSteps;
 		bool extraMeleeAttack;
 
 		Spawn* spawn;
@@ -150,6 +156,8 @@ class Monster : public Creature
 		void updateLookDirection();
 
 		void updateTargetList();
+		void updateTargetList(const Position& oldPos);
+		void pruneTargetList();
 		void clearTargetList();
 		void clearFriendList();
 
@@ -33,6 +33,8 @@
 #include <libxml/xmlmemory.h>
 #include <libxml/parser.h>
 
+#include <limits>
+
 extern Game g_game;
 extern Spells* g_spells;
 extern Monsters g_monsters;
@@ -46,6 +48,7 @@ MonsterType::MonsterType()
 void MonsterType::reset()
 {
 	experience = 0;
+	combatLogSource = NULL;
 
 	defense = 0;
 	armor = 0;
@@ -119,17 +122,59 @@ void MonsterType::reset()
 	changeTargetSpeed = 0;
 	changeTargetChance = 0;
 
+	attackRange = 0;
+	minDefenseSpeed = 0;
+	minSummonSpeed = 0;
+
 	scriptList.clear();
 }
 
+void MonsterType::compileBehavior()
+{
+	//the spell and summon lists are read on every think, keep them tight
+	SpellList(spellAttackList).swap(spellAttackList);
+	SpellList(spellDefenseList).swap(spellDefenseList);
+	SummonList(summonList).swap(summonList);
+
+	attackRange = 0;
+	for(SpellList::const_iterator it = spellAttackList.begin(); it != spellAttackList.end(); ++it)
+		attackRange = std::max(attackRange, it->range);
+
+	//an empty list keeps a minimum of 0 so the think loops behave as before
+	minDefenseSpeed = (spellDefenseList.empty() ? 0 : std::numeric_limits<uint32_t>::max());
+	for(SpellList::const_iterator it = spellDefenseList.begin(); it != spellDefenseList.end(); ++it)
+		minDefenseSpeed = std::min(minDefenseSpeed, it->speed);
+
+	minSummonSpeed = (summonList.empty() ? 0 : std::numeric_limits<uint32_t>::max());
+	for(SummonList::const_iterator it = summonList.begin(); it != summonList.end(); ++it)
+		minSummonSpeed = std::min(minSummonSpeed, it->speed);
+}
+
 MonsterType::~MonsterType()
 {
 	reset();
 }
 
+uint32_t Monsters::lootRandomState = 1;
+
+void Monsters::seedLootRandom(uint32_t seed)
+{
+	if(seed == 0)
+		seed = (uint32_t)OTSYS_TIME() ^ (uint32_t)time(NULL);
+
+	//xorshift must never be in the all zero state
+	lootRandomState = (seed != 0 ? seed : 1);
+}
+
 uint32_t Monsters::getLootRandom()
 {
-	return random_range(0, MAX_LOOTCHANCE) / g_config.getNumber(ConfigManager::RATE_LOOT);
+	//xorshift32, one roll per loot block is far cheaper than random_range and repeatable with a fixed seed
+	uint32_t x = lootRandomState;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	lootRandomState = x;
+	return (x % (MAX_LOOTCHANCE + 1)) / g_config.getNumber(ConfigManager::RATE_LOOT);
 }
 
 void MonsterType::createLoot(Container* corpse)
@@ -258,6 +303,9 @@ Monsters::Monsters()
 bool Monsters::loadFromXml(bool reloading /*= false*/)
 {
 	loaded = false;
+	if(!reloading)
+		seedLootRandom(g_config.getNumber(ConfigManager::LOOT_SEED));
+
 	std::string filename = "data/monster/monsters.xml";
 
 	xmlDocPtr doc = xmlParseFile(filename.c_str());
@@ -1374,6 +1422,8 @@ bool Monsters::loadMonster(const std::string& file, const std::string& monster_n
 
 	if(monsterLoad)
 	{
+		mType->compileBehavior();
+
 		static uint32_t id = 0;
 		if(new_mType)
 		{
@@ -24,6 +24,8 @@
 #include <string>
 #include "creature.h"
 
+struct CombatLogSource;
+
 #define MAX_LOOTCHANCE 100000
 #define MAX_STATICWALK 100
 
@@ -80,8 +82,8 @@ struct voiceBlock_t
 };
 
 typedef std::list<LootBlock> LootItems;
-typedef std::list<summonBlock_t> SummonList;
-typedef std::list<spellBlock_t> SpellList;
+typedef std::vector<summonBlock_t> SummonList;
+typedef std::vector<spellBlock_t> SpellList;
 typedef std::vector<voiceBlock_t> VoiceVector;
 typedef std::list<std::string> MonsterScriptList;
 typedef std::map<CombatType_t, int32_t> ElementMap;
@@ -141,8 +143,18 @@ class MonsterType
 		int32_t changeTargetSpeed;
 		int32_t changeTargetChance;
 
+		//derived from the lists above once the type is loaded
+		uint32_t attackRange;
+		uint32_t minDefenseSpeed;
+		uint32_t minSummonSpeed;
+
+		//looked up by the combat log on the first cast, the source lives as long as the log
+		CombatLogSource* combatLogSource;
+
 		MonsterScriptList scriptList;
 
+		void compileBehavior();
+
 		void createLoot(Container* corpse);
 		bool createLootContainer(Container* parent, const LootBlock& lootblock);
 		std::list<Item*> createLootItem(const LootBlock& lootblock);
@@ -163,8 +175,11 @@ class Monsters
 		uint32_t getIdByName(const std::string& name);
 
 		static uint32_t getLootRandom();
+		static void seedLootRandom(uint32_t seed);
 
 	private:
+		static uint32_t lootRandomState;
+
 		ConditionDamage* getDamageCondition(ConditionType_t conditionType,
 			int32_t maxDamage, int32_t minDamage, int32_t startDamage, uint32_t tickInterval);
 		bool deserializeSpell(xmlNodePtr node, spellBlock_t& sb, const std::string& description = "");
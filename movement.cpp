@@ -105,6 +105,7 @@ void MoveEvents::clear()
 		posIter = m_positionMap.begin();
 	}
 
+	m_itemIdIndex.clear();
 	m_scriptInterface.reInitState();
 }
 
@@ -248,6 +249,22 @@ void MoveEvents::addEvent(MoveEvent* moveEvent, int32_t id, MoveListMap& map)
 		}
 		moveEventList.push_back(moveEvent);
 	}
+
+	if(&map == &m_itemIdMap && id >= 0)
+	{
+		if((size_t)id >= m_itemIdIndex.size())
+			m_itemIdIndex.resize(id + 1, NULL);
+
+		m_itemIdIndex[id] = &map[id];
+	}
+}
+
+MoveEventList* MoveEvents::getItemIdEvents(uint16_t itemId) const
+{
+	if(itemId < m_itemIdIndex.size())
+		return m_itemIdIndex[itemId];
+
+	return NULL;
 }
 
 MoveEvent* MoveEvents::getEvent(Item* item, MoveEvent_t eventType, slots_t slot)
@@ -289,10 +306,9 @@ MoveEvent* MoveEvents::getEvent(Item* item, MoveEvent_t eventType, slots_t slot)
 			break;
 	}
 
-	MoveListMap::iterator it = m_itemIdMap.find(item->getID());
-	if(it != m_itemIdMap.end())
+	if(MoveEventList* itemIdEvents = getItemIdEvents(item->getID()))
 	{
-		std::list<MoveEvent*>& moveEventList = it->second.moveEvent[eventType];
+		std::list<MoveEvent*>& moveEventList = itemIdEvents->moveEvent[eventType];
 		for(std::list<MoveEvent*>::iterator it = moveEventList.begin(); it != moveEventList.end(); ++it)
 		{
 			if(((*it)->getSlot() & slotp) != 0)
@@ -327,10 +343,9 @@ MoveEvent* MoveEvents::getEvent(Item* item, MoveEvent_t eventType)
 		}
 	}
 
-	it = m_itemIdMap.find(item->getID());
-	if(it != m_itemIdMap.end())
+	if(MoveEventList* itemIdEvents = getItemIdEvents(item->getID()))
 	{
-		std::list<MoveEvent*>& moveEventList = it->second.moveEvent[eventType];
+		std::list<MoveEvent*>& moveEventList = itemIdEvents->moveEvent[eventType];
 		if(!moveEventList.empty())
 			return *moveEventList.begin();
 	}
@@ -24,6 +24,7 @@
 #include "luascript.h"
 #include "baseevents.h"
 #include <map>
+#include <vector>
 
 enum MoveEvent_t
 {
@@ -64,6 +65,7 @@ class MoveEvents : public BaseEvents
 	protected:
 		typedef std::map<int32_t, MoveEventList> MoveListMap;
 		typedef std::map<Position, MoveEventList> MovePosListMap;
+		typedef std::vector<MoveEventList*> MoveListIndex;
 		virtual void clear();
 		virtual LuaScriptInterface& getScriptInterface();
 		virtual std::string getScriptBaseName();
@@ -80,12 +82,17 @@ class MoveEvents : public BaseEvents
 		MoveEvent* getEvent(const Tile* tile, MoveEvent_t eventType);
 
 		MoveEvent* getEvent(Item* item, MoveEvent_t eventType, slots_t slot);
+		MoveEventList* getItemIdEvents(uint16_t itemId) const;
 
 		MoveListMap m_uniqueIdMap;
 		MoveListMap m_actionIdMap;
 		MoveListMap m_itemIdMap;
 		MovePosListMap m_positionMap;
 
+		//m_itemIdMap entries indexed by item id, so stepping on fields and other
+		//tile items does not need a map search per item
+		MoveListIndex m_itemIdIndex;
+
 		LuaScriptInterface m_scriptInterface;
 };
 
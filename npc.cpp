@@ -142,6 +142,12 @@ void Npc::reset()
 	responseList.clear();
 	stateList.clear();
 	queueList.clear();
+
+	keywordNodes.clear();
+	keywordNodes.push_back(KeywordNode());
+	keywordCount = 0;
+	keywordMatches.clear();
+	keywordMatchesValid = false;
 	m_parameters.clear();
 	itemListMap.clear();
 	responseScriptMap.clear();
@@ -286,6 +292,7 @@ bool Npc::loadFromXml(const std::string& filename)
 					defaultPublic = intValue != 0;
 
 				responseList = loadInteraction(p->children);
+				compileKeywords(responseList);
 			}
 			p = p->next;
 		}
@@ -1216,6 +1223,10 @@ void Npc::onCreatureAppear(const Creature* creature, bool isLogin)
 	//only players for script events
 	else if(Player* player = const_cast<Player*>(creature->getPlayer()))
 	{
+		//wake up from hibernation
+		if(isInHibernateRange(player->getPosition()))
+			g_game.addCreatureCheck(this);
+
 		if(m_npcEventHandler)
 			m_npcEventHandler->onCreatureAppear(creature);
 
@@ -1264,6 +1275,9 @@ void Npc::onCreatureMove(const Creature* creature, const Tile* newTile, const Po
 	}
 	else if(Player* player = const_cast<Player*>(creature->getPlayer()))
 	{
+		if(isInHibernateRange(newPos))
+			g_game.addCreatureCheck(this);
+
 		if(m_npcEventHandler)
 			m_npcEventHandler->onCreatureMove(creature, oldPos, newPos);
 
@@ -1302,6 +1316,8 @@ void Npc::onCreatureSay(const Creature* creature, SpeakClasses type, const std::
 	//only players for script events
 	if(Player* player = const_cast<Player*>(creature->getPlayer()))
 	{
+		//a player may talk from outside hibernateNpcRange, delayed replies and talk queues need onThink
+		g_game.addCreatureCheck(this);
 		if(m_npcEventHandler)
 			m_npcEventHandler->onCreatureSay(player, type, text);
 
@@ -1342,6 +1358,7 @@ void Npc::onCreatureSay(const Creature* creature, SpeakClasses type, const std::
 
 void Npc::onPlayerCloseChannel(const Player* player)
 {
+	g_game.addCreatureCheck(this);
 	if(m_npcEventHandler)
 		m_npcEventHandler->onPlayerCloseChannel(player);
 }
@@ -1480,6 +1497,32 @@ void Npc::onThink(uint32_t interval)
 
 	if(isIdle && !hasScriptedFocus)
 		setCreatureFocus(NULL);
+
+	if(isIdle && stateList.empty() && queueList.empty() && g_config.getBoolean(ConfigManager::HIBERNATE_NPCS))
+	{
+		//nobody around to talk to, stop thinking until a player shows up again
+		const SpectatorVec& list = g_game.getSpectators(getPosition());
+		SpectatorVec::const_iterator it = list.begin();
+		while(it != list.end() && !((*it)->getPlayer() && isInHibernateRange((*it)->getPosition())))
+			++it;
+
+		if(it == list.end())
+			g_game.removeCreatureCheck(this);
+	}
+}
+
+bool Npc::isInHibernateRange(const Position& pos) const
+{
+	//appear and move events only reach the viewport, so a range can narrow it but not widen it
+	int32_t range = g_config.getNumber(ConfigManager::HIBERNATE_NPC_RANGE);
+	if(range <= 0)
+		return true;
+
+	//never below the talk radius, anyone who can talk to us must keep us thinking
+	range = std::max(range, talkRadius);
+
+	const Position& npcPos = getPosition();
+	return pos.z == npcPos.z && std::abs(pos.x - npcPos.x) <= range && std::abs(pos.y - npcPos.y) <= range;
 }
 
 void Npc::processResponse(Player* player, NpcState* npcState, const NpcResponse* response, bool delayResponse /*= false*/)
@@ -2175,6 +2218,7 @@ const NpcResponse* Npc::getResponse(const ResponseList& list, const Player* play
 {
 	std::string textString = asLowerCaseString(text);
 	std::vector<std::string> wordList = explodeString(textString, " ");
+	keywordMatchesValid = matchWords(wordList);
 
 	// We choose the match that matches the most keywords
 	// _and_ matches all of it's conditions.
@@ -2581,17 +2625,73 @@ const NpcResponse* Npc::getResponse(const ResponseList& list, const Player* play
 	return NULL;
 }
 
-int32_t Npc::matchKeywords(NpcResponse* response, std::vector<std::string> wordList, bool exactMatch)
+int32_t Npc::matchKeywords(NpcResponse* response, const std::vector<std::string>& wordList, bool exactMatch)
 {
 	int32_t bestMatchCount = 0;
 	if(wordList.empty())
 		return 0;
 
+	const std::vector<KeywordSequence>& keywordList = response->getKeywordList();
+	if(keywordMatchesValid && keywordList.size() == response->getInputList().size())
+	{
+		//same rules as below, but the words each keyword matches are already known
+		for(std::vector<KeywordSequence>::const_iterator it = keywordList.begin(); it != keywordList.end(); ++it)
+		{
+			int32_t matchCount = 0;
+			size_t lastWordMatch = 0;
+			for(KeywordSequence::const_iterator keyIter = it->begin(); keyIter != it->end(); ++keyIter)
+			{
+				if(!exactMatch && keyIter->type == KEYWORD_ANY)
+				{
+					//Match anything.
+				}
+				else if(keyIter->type == KEYWORD_AMOUNT)
+				{
+					if(lastWordMatch == wordList.size())
+						continue;
+
+					int32_t amount = atoi(wordList[lastWordMatch].c_str());
+					if(amount > 0)
+					{
+						if(amount <= 500)
+							response->setAmount(amount);
+						else
+							response->setAmount(500);
+					}
+					else
+					{
+						response->setAmount(1);
+						continue;
+					}
+				}
+				else
+				{
+					uint64_t wordMask = keywordMatches[keyIter->id];
+					size_t word = lastWordMatch;
+					while(word < wordList.size() && !(wordMask & ((uint64_t)1 << word)))
+						++word;
+
+					if(word == wordList.size())
+						continue;
+
+					lastWordMatch = word + 1;
+				}
+
+				++matchCount;
+			}
+
+			if((size_t)matchCount == it->size() && matchCount > bestMatchCount)
+				bestMatchCount = matchCount;
+		}
+
+		return bestMatchCount;
+	}
+
 	const std::list<std::string>& inputList = response->getInputList();
 	for(std::list<std::string>::const_iterator it = inputList.begin(); it != inputList.end(); ++it)
 	{
 		int32_t matchCount = 0;
-		std::vector<std::string>::iterator lastWordMatchIter = wordList.begin();
+		std::vector<std::string>::const_iterator lastWordMatchIter = wordList.begin();
 		std::string keywords = (*it);
 		std::vector<std::string> keywordList = explodeString(keywords, ";");
 
@@ -2630,7 +2730,7 @@ int32_t Npc::matchKeywords(NpcResponse* response, std::vector<std::string> wordL
 						fullMatch = true;
 				}
 
-				std::vector<std::string>::iterator wordIter = wordList.end();
+				std::vector<std::string>::const_iterator wordIter = wordList.end();
 				for(wordIter = lastWordMatchIter; wordIter != wordList.end(); ++wordIter)
 				{
 					if(fullMatch)
@@ -2658,6 +2758,103 @@ int32_t Npc::matchKeywords(NpcResponse* response, std::vector<std::string> wordL
 	return bestMatchCount;
 }
 
+int32_t Npc::addKeyword(const std::string& keyword)
+{
+	bool fullMatch = (!keyword.empty() && keyword[keyword.size() - 1] == '$');
+	size_t length = (fullMatch ? keyword.size() - 1 : keyword.size());
+
+	uint32_t node = 0;
+	for(size_t i = 0; i < length; ++i)
+	{
+		std::map<char, uint32_t>::const_iterator it = keywordNodes[node].children.find(keyword[i]);
+		if(it != keywordNodes[node].children.end())
+			node = it->second;
+		else
+		{
+			uint32_t child = keywordNodes.size();
+			keywordNodes[node].children[keyword[i]] = child;
+			keywordNodes.push_back(KeywordNode());
+			node = child;
+		}
+	}
+
+	int32_t& id = (fullMatch ? keywordNodes[node].fullId : keywordNodes[node].prefixId);
+	if(id == -1)
+		id = keywordCount++;
+
+	return id;
+}
+
+void Npc::compileKeywords(const ResponseList& list)
+{
+	for(ResponseList::const_iterator it = list.begin(); it != list.end(); ++it)
+	{
+		NpcResponse* response = *it;
+		response->keywordList.clear();
+
+		const std::list<std::string>& inputList = response->getInputList();
+		for(std::list<std::string>::const_iterator iit = inputList.begin(); iit != inputList.end(); ++iit)
+		{
+			KeywordSequence sequence;
+			std::vector<std::string> keywordList = explodeString(*iit, ";");
+			for(std::vector<std::string>::iterator keyIter = keywordList.begin(); keyIter != keywordList.end(); ++keyIter)
+			{
+				NpcKeyword keyword;
+				keyword.type = KEYWORD_TEXT;
+				if((*keyIter) == "|*|")
+					keyword.type = KEYWORD_ANY;
+				else if((*keyIter) == "|amount|")
+					keyword.type = KEYWORD_AMOUNT;
+
+				//|*| is an ordinary keyword when an exact match is requested
+				keyword.id = (keyword.type == KEYWORD_AMOUNT ? -1 : addKeyword(*keyIter));
+				sequence.push_back(keyword);
+			}
+
+			response->keywordList.push_back(sequence);
+		}
+
+		compileKeywords(response->getResponseList());
+	}
+}
+
+bool Npc::matchWords(const std::vector<std::string>& wordList)
+{
+	if(wordList.size() > 64)
+		return false;
+
+	keywordMatches.assign(keywordCount, 0);
+	for(size_t i = 0; i < wordList.size(); ++i)
+	{
+		const std::string& word = wordList[i];
+		uint64_t wordBit = (uint64_t)1 << i;
+
+		uint32_t node = 0;
+		for(size_t pos = 0; ; ++pos)
+		{
+			const KeywordNode& keywordNode = keywordNodes[node];
+			if(keywordNode.prefixId != -1)
+				keywordMatches[keywordNode.prefixId] |= wordBit;
+
+			if(pos == word.size())
+			{
+				if(keywordNode.fullId != -1)
+					keywordMatches[keywordNode.fullId] |= wordBit;
+
+				break;
+			}
+
+			std::map<char, uint32_t>::const_iterator it = keywordNode.children.find(word[pos]);
+			if(it == keywordNode.children.end())
+				break;
+
+			node = it->second;
+		}
+	}
+
+	return true;
+}
+
 const NpcResponse* Npc::getResponse(const Player* player, NpcState* npcState,
 	const std::string& text, bool checkSubResponse)
 {
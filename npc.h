@@ -320,6 +320,22 @@ typedef std::list<ResponseAction> ActionList;
 typedef std::map<std::string, int32_t> ResponseScriptMap;
 typedef std::list<NpcResponse*> ResponseList;
 
+enum KeywordType_t
+{
+	KEYWORD_TEXT,
+	KEYWORD_ANY,
+	KEYWORD_AMOUNT
+};
+
+//one ';' separated part of an input, text keywords refer to the npc keyword trie
+struct NpcKeyword
+{
+	KeywordType_t type;
+	int32_t id;
+};
+
+typedef std::vector<NpcKeyword> KeywordSequence;
+
 class NpcResponse
 {
 	public:
@@ -387,6 +403,7 @@ class NpcResponse
 		NpcResponse(NpcResponse& rhs)
 		{
 			prop = rhs.prop;
+			keywordList = rhs.keywordList;
 			scriptVars = rhs.scriptVars;
 			for(ResponseList::iterator it = rhs.subResponseList.begin(); it != rhs.subResponseList.end(); ++it)
 			{
@@ -425,6 +442,7 @@ class NpcResponse
 		std::string formatResponseString(Creature* creature) const;
 		void addAction(ResponseAction action) {prop.actionList.push_back(action);}
 		const std::list<std::string>& getInputList() const { return prop.inputList;}
+		const std::vector<KeywordSequence>& getKeywordList() const {return keywordList;}
 
 		void setResponseList(ResponseList _list) { subResponseList.insert(subResponseList.end(),_list.begin(),_list.end());}
 		const ResponseList& getResponseList() const { return subResponseList;}
@@ -433,6 +451,7 @@ class NpcResponse
 		ActionList::const_iterator getEndAction() const {return prop.actionList.end();}
 
 		ResponseProperties prop;
+		std::vector<KeywordSequence> keywordList;
 		ResponseList subResponseList;
 		ScriptVars scriptVars;
 };
@@ -539,6 +558,7 @@ class Npc : public Creature
 		virtual bool getNextStep(Direction& dir, uint32_t& flags);
 
 		bool canWalkTo(const Position& fromPos, Direction dir);
+		bool isInHibernateRange(const Position& pos) const;
 		bool getRandomStep(Direction& dir);
 
 		void reset();
@@ -554,7 +574,21 @@ class Npc : public Creature
 		const NpcResponse* getResponse(const Player* player, NpcState* npcState,
 			NpcEvent_t eventType, bool checkLastResponse);
 
-		int32_t matchKeywords(NpcResponse* response, std::vector<std::string> wordList, bool exactMatch);
+		int32_t matchKeywords(NpcResponse* response, const std::vector<std::string>& wordList, bool exactMatch);
+
+		//all text keywords of the npc, walked once per word of a sentence
+		struct KeywordNode
+		{
+			KeywordNode() : prefixId(-1), fullId(-1) {}
+
+			std::map<char, uint32_t> children;
+			int32_t prefixId;
+			int32_t fullId;
+		};
+
+		int32_t addKeyword(const std::string& keyword);
+		void compileKeywords(const ResponseList& list);
+		bool matchWords(const std::vector<std::string>& wordList);
 
 		void processResponse(Player* player, NpcState* npcState, const NpcResponse* response, bool delayResponse = false);
 		void executeResponse(Player* player, NpcState* npcState, const NpcResponse* response);
@@ -602,6 +636,12 @@ class Npc : public Creature
 		ResponseScriptMap responseScriptMap;
 		ResponseList responseList;
 
+		std::vector<KeywordNode> keywordNodes;
+		int32_t keywordCount;
+		//bit i is set when the keyword matches word i of the current sentence
+		std::vector<uint64_t> keywordMatches;
+		bool keywordMatchesValid;
+
 		typedef std::list<NpcState*> StateList;
 		StateList stateList;
 		NpcEventsHandler* m_npcEventHandler;
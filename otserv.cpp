@@ -79,6 +79,8 @@
 #include "admin.h"
 #include "globalevent.h"
 #include "mounts.h"
+#include "combatlog.h"
+#include "combatbench.h"
 
 #ifdef __OTSERV_ALLOCATOR__
 #include "allocator.h"
@@ -501,6 +503,24 @@ void mainLoader(ServiceManager* services)
 	status->setMapAuthor(g_config.getString(ConfigManager::MAP_AUTHOR));
 	status->setMapName(g_config.getString(ConfigManager::MAP_NAME));
 
+	if(g_config.getBoolean(ConfigManager::COMBAT_LOG_ENABLED))
+	{
+		std::cout << ">> Starting combat log" << std::endl;
+		if(!CombatLog::getInstance()->start(g_config.getString(ConfigManager::COMBAT_LOG_FILE)))
+			std::cout << "> WARNING: Unable to open the combat log, it stays disabled." << std::endl;
+	}
+
+	#if defined(_CONSOLE) && defined(__COMBAT_BENCH__)
+	//fights on a generated arena instead of the map, then quits without opening any port
+	CombatBenchConfig benchConfig;
+	if(CombatBench::parseArguments(argc, argv, benchConfig))
+	{
+		bool success = CombatBench::getInstance()->run(benchConfig);
+		CombatLog::getInstance()->stop();
+		exit(success ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+	#endif
+
 	std::cout << ">> Loading map" << std::endl;
 	#ifndef _CONSOLE
 	SendMessage(GUI::getInstance()->m_statusBar, WM_SETTEXT, 0, (LPARAM)">> Loading map");
@@ -29,6 +29,11 @@
 
 typedef std::vector< std::pair<uint32_t, uint32_t> > IPList;
 
+#ifdef __COMBAT_BENCH__
+//game time set by the combat benchmark, replaces the wall clock in OTSYS_TIME while non-zero
+extern int64_t g_benchTime;
+#endif
+
 #ifdef WIN32
 #ifdef __WIN_LOW_FRAG_HEAP__
 #define _WIN32_WINNT 0x0501
@@ -60,6 +65,11 @@ typedef HANDLE OTSYS_THREAD_SIGNALVAR;
 
 inline int64_t OTSYS_TIME()
 {
+#ifdef __COMBAT_BENCH__
+	if(g_benchTime != 0)
+		return g_benchTime;
+
+#endif
 	_timeb t;
 	_ftime(&t);
 	return int64_t(t.millitm) + int64_t(t.time) * 1000;
@@ -150,6 +160,11 @@ inline void OTSYS_SLEEP(int t)
 
 inline int64_t OTSYS_TIME()
 {
+#ifdef __COMBAT_BENCH__
+	if(g_benchTime != 0)
+		return g_benchTime;
+
+#endif
 	timeb t;
 	ftime(&t);
 	return ((int64_t)t.millitm) + ((int64_t)t.time) * 1000;
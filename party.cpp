@@ -361,18 +361,27 @@ void Party::shareExperience(uint64_t experience)
 	getLeader()->onGainSharedExperience(shareExperience);
 }
 
-bool Party::canUseSharedExperience(const Player* player) const
+uint32_t Party::getHighestLevel() const
 {
-	if(!memberList.size())
-		return false;
-
 	uint32_t highestLevel = getLeader()->getLevel();
 	for(PlayerVector::const_iterator it = memberList.begin(); it != memberList.end(); ++it)
 	{
 		if((*it)->getLevel() > highestLevel)
 			highestLevel = (*it)->getLevel();
 	}
+	return highestLevel;
+}
+
+bool Party::canUseSharedExperience(const Player* player) const
+{
+	if(!memberList.size())
+		return false;
+
+	return canUseSharedExperience(player, getHighestLevel());
+}
 
+bool Party::canUseSharedExperience(const Player* player, uint32_t highestLevel) const
+{
 	uint32_t minLevel = (int32_t)std::ceil(((float)(highestLevel) * 2) / 3);
 	if(player->getLevel() < minLevel)
 		return false;
@@ -399,12 +408,17 @@ bool Party::canUseSharedExperience(const Player* player) const
 
 bool Party::canEnableSharedExperience()
 {
-	if(!canUseSharedExperience(getLeader()))
+	if(!memberList.size())
+		return false;
+
+	//the level range only depends on the highest level, so it is computed once for all members
+	uint32_t highestLevel = getHighestLevel();
+	if(!canUseSharedExperience(getLeader(), highestLevel))
 		return false;
 
 	for(PlayerVector::iterator it = memberList.begin(); it != memberList.end(); ++it)
 	{
-		if(!canUseSharedExperience(*it))
+		if(!canUseSharedExperience(*it, highestLevel))
 			return false;
 	}
 
@@ -86,6 +86,8 @@ class Party
 		CountMap pointMap;
 
 		bool canEnableSharedExperience();
+		bool canUseSharedExperience(const Player* player, uint32_t highestLevel) const;
+		uint32_t getHighestLevel() const;
 };
 
 #endif
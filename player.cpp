@@ -43,6 +43,7 @@
 #include "mounts.h"
 #include "quests.h"
 #include "outputmessage.h"
+#include "combatlog.h"
 #ifndef _CONSOLE
 #include "gui.h"
 #endif
@@ -61,6 +62,54 @@ int32_t Player::maxMessageBuffer;
 
 #ifdef __ENABLE_SERVER_DIAGNOSTIC__
 uint32_t Player::playerCount = 0;
+uint64_t Player::statsRequested = 0;
+uint64_t Player::statsSent = 0;
+uint64_t Player::skullChecks = 0;
+uint64_t Player::skullChecksSkipped = 0;
+PlayerSubsystemStats Player::subsystemStats[PLAYER_SUBSYSTEM_LAST];
+
+const char* Player::getSubsystemName(PlayerSubsystem_t subsystem)
+{
+	switch(subsystem)
+	{
+		case PLAYER_SUBSYSTEM_TRAINING:
+			return "offline training";
+		case PLAYER_SUBSYSTEM_STATS:
+			return "stats packets";
+		default:
+			break;
+	}
+
+	return "unknown";
+}
+
+//adds the time spent until the end of the scope to a player subsystem,
+//the game clock only has millisecond resolution so this uses the boost clock.
+//it costs two clock reads, so only wrap parts that do real work
+class PlayerSubsystemTimer
+{
+	public:
+		PlayerSubsystemTimer(PlayerSubsystem_t _subsystem)
+		{
+			subsystem = _subsystem;
+			start = boost::get_system_time();
+		}
+
+		~PlayerSubsystemTimer()
+		{
+			PlayerSubsystemStats& stats = Player::subsystemStats[subsystem];
+			stats.calls++;
+			stats.time += (boost::get_system_time() - start).total_microseconds();
+		}
+
+	private:
+		PlayerSubsystem_t subsystem;
+		boost::system_time start;
+};
+
+#define PLAYER_SUBSYSTEM_TIMER(subsystem) PlayerSubsystemTimer playerSubsystemTimer(subsystem)
+#else
+#define PLAYER_SUBSYSTEM_TIMER(subsystem)
 #endif
 
 Player::Player(const std::string& _name, ProtocolGame *p) :
@@ -77,6 +126,7 @@ Creature()
 	name = _name;
 	setVocation(0);
 	capacity = 400.00;
+	inventoryArmor = 0;
 	mana = 0;
 	manaMax = 0;
 	manaSpent = 0;
@@ -168,6 +218,12 @@ Creature()
 	for(int32_t i = STAT_FIRST; i <= STAT_LAST; ++i)
 		varStats[i] = 0;
 
+	for(int32_t i = 0; i < 256; ++i)
+		spellCooldowns[i] = 0;
+
+	for(int32_t i = SPELLGROUP_NONE; i <= SPELLGROUP_LAST; ++i)
+		spellGroupCooldowns[i] = 0;
+
 	maxDepotLimit = 1000;
 	maxVipLimit = 20;
 	groupFlags = 0;
@@ -184,7 +240,7 @@ Creature()
 
 	idleTime = 0;
 
-	skullTicks = 0;
+	skullEndTime = 0;
 	skull = SKULL_NONE;
 	setParty(NULL);
 
@@ -198,6 +254,7 @@ Creature()
 	offlineTrainingSkill = -1;
 	offlineTrainingTime = 0;
 	lastStatsTrainingTime = 0;
+	statsPending = false;
 
 	ghostMode = false;
 	requestedOutfit = false;
@@ -454,22 +511,11 @@ int32_t Player::getWeaponSkill(const Item* item) const
 
 int32_t Player::getArmor() const
 {
-	int32_t armor = 0;
-
-	if(getInventoryItem(SLOT_HEAD))
-		armor += getInventoryItem(SLOT_HEAD)->getArmor();
-	if(getInventoryItem(SLOT_NECKLACE))
-		armor += getInventoryItem(SLOT_NECKLACE)->getArmor();
-	if(getInventoryItem(SLOT_ARMOR))
-		armor += getInventoryItem(SLOT_ARMOR)->getArmor();
-	if(getInventoryItem(SLOT_LEGS))
-		armor += getInventoryItem(SLOT_LEGS)->getArmor();
-	if(getInventoryItem(SLOT_FEET))
-		armor += getInventoryItem(SLOT_FEET)->getArmor();
-	if(getInventoryItem(SLOT_RING))
-		armor += getInventoryItem(SLOT_RING)->getArmor();
-
-	return int32_t(armor * vocation->armorMultipler);
+#ifdef __DEBUG__
+	//an inventory change that skipped updateInventoryArmor
+	assert(inventoryArmor == sumInventoryArmor());
+#endif
+	return int32_t(inventoryArmor * vocation->armorMultipler);
 }
 
 void Player::getShieldAndWeapon(const Item* &shield, const Item* &weapon) const
@@ -630,6 +676,24 @@ void Player::updateInventoryWeight()
 	}
 }
 
+void Player::updateInventoryArmor()
+{
+	inventoryArmor = sumInventoryArmor();
+}
+
+int32_t Player::sumInventoryArmor() const
+{
+	static const slots_t armorSlots[] = {SLOT_HEAD, SLOT_NECKLACE, SLOT_ARMOR, SLOT_LEGS, SLOT_FEET, SLOT_RING};
+
+	int32_t armor = 0;
+	for(uint32_t i = 0; i < sizeof(armorSlots) / sizeof(armorSlots[0]); ++i)
+	{
+		if(Item* item = getInventoryItem(armorSlots[i]))
+			armor += item->getArmor();
+	}
+	return armor;
+}
+
 int32_t Player::getPlayerInfo(playerinfo_t playerinfo) const
 {
 	switch(playerinfo)
@@ -1328,8 +1392,28 @@ void Player::sendCancelMessage(ReturnValue message) const
 
 void Player::sendStats()
 {
+	if(!client)
+		return;
+
+#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+	statsRequested++;
+#endif
+	if(statsPending)
+		return;
+
+	statsPending = true;
+	g_game.addPendingStats(this);
+}
+
+void Player::flushStats()
+{
+	statsPending = false;
 	if(client)
 	{
+		PLAYER_SUBSYSTEM_TIMER(PLAYER_SUBSYSTEM_STATS);
+#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+		statsSent++;
+#endif
 		client->sendStats();
 		lastStatsTrainingTime = getOfflineTrainingTime() / 60 / 1000;
 	}
@@ -1500,6 +1584,8 @@ void Player::onCreatureAppear(const Creature* creature, bool isLogin)
 			storedConditionList.clear();
 		}
 
+		sendSpellCooldowns();
+
 		BedItem* bed = Beds::getInstance().getBedBySleeper(getGUID());
 		if(bed)
 		{
@@ -1921,11 +2007,25 @@ void Player::onThink(uint32_t interval)
 		}
 	}
 
+	//frags expire by timestamp, only a red/black skull has to be checked for removal
 	if(g_game.getWorldType() != WORLD_TYPE_PVP_ENFORCED)
-		checkSkullTicks(interval);
+	{
+		if(skull == SKULL_RED || skull == SKULL_BLACK)
+		{
+#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+			skullChecks++;
+#endif
+			checkSkullTicks();
+		}
+#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+		else
+			skullChecksSkipped++;
+#endif
+	}
 
+	PLAYER_SUBSYSTEM_TIMER(PLAYER_SUBSYSTEM_TRAINING);
 	addOfflineTrainingTime(interval);
-	if(lastStatsTrainingTime != getOfflineTrainingTime() / 60 / 1000)
+	if(!statsPending && lastStatsTrainingTime != getOfflineTrainingTime() / 60 / 1000)
 		sendStats();
 }
 
@@ -2538,12 +2638,69 @@ void Player::addInFightTicks(bool pzlock /*= false*/)
 	addCondition(condition);
 }
 
+bool Player::hasSpellCooldown(uint8_t spellId) const
+{
+	return spellCooldowns[spellId] > OTSYS_TIME();
+}
+
+bool Player::hasSpellGroupCooldown(SpellGroup_t groupId) const
+{
+	if(groupId < SPELLGROUP_NONE || groupId > SPELLGROUP_LAST)
+		return false;
+
+	return spellGroupCooldowns[groupId] > OTSYS_TIME();
+}
+
+void Player::addSpellCooldown(uint8_t spellId, uint32_t ticks)
+{
+	int64_t endTime = OTSYS_TIME() + ticks;
+	if(spellCooldowns[spellId] > endTime)
+		return;
+
+	spellCooldowns[spellId] = endTime;
+	if(spellId != 0 && ticks > 0)
+		sendSpellCooldown(spellId, ticks);
+}
+
+void Player::addSpellGroupCooldown(SpellGroup_t groupId, uint32_t ticks)
+{
+	if(groupId < SPELLGROUP_NONE || groupId > SPELLGROUP_LAST)
+		return;
+
+	int64_t endTime = OTSYS_TIME() + ticks;
+	if(spellGroupCooldowns[groupId] > endTime)
+		return;
+
+	spellGroupCooldowns[groupId] = endTime;
+	if(groupId != SPELLGROUP_NONE && ticks > 0)
+		sendSpellGroupCooldown(groupId, ticks);
+}
+
+void Player::sendSpellCooldowns()
+{
+	int64_t timeNow = OTSYS_TIME();
+	for(int32_t i = 1; i < 256; ++i)
+	{
+		if(spellCooldowns[i] > timeNow)
+			sendSpellCooldown(i, spellCooldowns[i] - timeNow);
+	}
+
+	for(int32_t i = SPELLGROUP_NONE + 1; i <= SPELLGROUP_LAST; ++i)
+	{
+		if(spellGroupCooldowns[i] > timeNow)
+			sendSpellGroupCooldown((SpellGroup_t)i, spellGroupCooldowns[i] - timeNow);
+	}
+}
+
 void Player::addDefaultRegeneration(uint32_t addTicks)
 {
 	Condition* condition = getCondition(CONDITION_REGENERATION, CONDITIONID_DEFAULT);
 
 	if(condition)
+	{
 		condition->setTicks(condition->getTicks() + addTicks);
+		invalidateConditionsCheck();
+	}
 	else
 	{
 		condition = Condition::createCondition(CONDITIONID_DEFAULT, CONDITION_REGENERATION, addTicks, 0);
@@ -3430,6 +3587,7 @@ void Player::postAddNotification(Thing* thing, const Cylinder* oldParent, int32_
 			requireListUpdate = oldParent != this;
 
 		updateInventoryWeight();
+		updateInventoryArmor();
 		updateItemsLight();
 		sendStats();
 	}
@@ -3482,6 +3640,7 @@ void Player::postRemoveNotification(Thing* thing, const Cylinder* newParent, int
 			requireListUpdate = newParent != this;
 
 		updateInventoryWeight();
+		updateInventoryArmor();
 		updateItemsLight();
 		sendStats();
 	}
@@ -3678,6 +3837,7 @@ void Player::doAttacking(uint32_t interval)
 		bool result = false;
 		if(weapon)
 		{
+			CombatLogScope logScope(weapon->combatLogSource, Item::items[tool->getID()].name);
 			if(!weapon->interruptSwing())
 				result = weapon->useWeapon(this, tool, attackedCreature);
 			else if(!canDoAction())
@@ -3908,7 +4068,10 @@ void Player::onCombatRemoveCondition(const Creature* attacker, Condition* condit
 			if(delay < 0)
 				removeCondition(condition);
 			else
+			{
 				condition->setTicks(delay);
+				invalidateConditionsCheck();
+			}
 		}
 		else
 			removeCondition(condition);
@@ -4322,7 +4485,8 @@ void Player::addUnjustifiedDead(const Player* attacked)
 		client->sendTextMessage(MSG_EVENT_ADVANCE, ss.str());
 	}
 
-	skullTicks += g_config.getNumber(ConfigManager::FRAG_TIME);
+	int64_t skullTicks = getSkullTicks() + g_config.getNumber(ConfigManager::FRAG_TIME);
+	skullEndTime = OTSYS_TIME() + skullTicks;
 	if(g_config.getNumber(ConfigManager::KILLS_TO_BAN) != 0 && skullTicks > (g_config.getNumber(ConfigManager::KILLS_TO_BAN) - 1) * g_config.getNumber(ConfigManager::FRAG_TIME) && !IOBan::getInstance()->isAccountBanned(accountNumber))
 	{
 		IOBan::getInstance()->addAccountBan(accountNumber, time(NULL) + (g_config.getNumber(ConfigManager::BAN_DAYS) * 86400), 20, 2, "No comment.", 0);
@@ -4347,15 +4511,9 @@ void Player::addUnjustifiedDead(const Player* attacked)
 	}
 }
 
-void Player::checkSkullTicks(int32_t ticks)
+void Player::checkSkullTicks()
 {
-	int32_t newTicks = skullTicks - ticks;
-	if(newTicks < 0)
-		skullTicks = 0;
-	else
-		skullTicks = newTicks;
-
-	if((skull == SKULL_RED || skull == SKULL_BLACK) && skullTicks < 1000 && !hasCondition(CONDITION_INFIGHT))
+	if((skull == SKULL_RED || skull == SKULL_BLACK) && getSkullTicks() < 1000 && !hasCondition(CONDITION_INFIGHT))
 	{
 		setSkull(SKULL_NONE);
 		g_game.updateCreatureSkull(this);
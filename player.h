@@ -145,11 +145,34 @@ typedef std::list<Party*> PartyList;
 #define PLAYER_MAX_SPEED 1500
 #define PLAYER_MIN_SPEED 10
 
+#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+enum PlayerSubsystem_t
+{
+	PLAYER_SUBSYSTEM_TRAINING,
+	PLAYER_SUBSYSTEM_STATS,
+	PLAYER_SUBSYSTEM_LAST
+};
+
+struct PlayerSubsystemStats
+{
+	PlayerSubsystemStats() : calls(0), time(0) {}
+
+	uint64_t calls;
+	uint64_t time; //microseconds
+};
+#endif
+
 class Player : public Creature, public Cylinder
 {
 	public:
 #ifdef __ENABLE_SERVER_DIAGNOSTIC__
 		static uint32_t playerCount;
+		static uint64_t statsRequested;
+		static uint64_t statsSent;
+		static uint64_t skullChecks;
+		static uint64_t skullChecksSkipped;
+		static PlayerSubsystemStats subsystemStats[PLAYER_SUBSYSTEM_LAST];
+		static const char* getSubsystemName(PlayerSubsystem_t subsystem);
 #endif
 		Player(const std::string& name, ProtocolGame* p);
 		virtual ~Player();
@@ -503,6 +526,12 @@ class Player : public Creature, public Cylinder
 		void addCombatExhaust(uint32_t ticks);
 		void addHealExhaust(uint32_t ticks);
 		void addInFightTicks(bool pzlock = false);
+
+		bool hasSpellCooldown(uint8_t spellId) const;
+		bool hasSpellGroupCooldown(SpellGroup_t groupId) const;
+		void addSpellCooldown(uint8_t spellId, uint32_t ticks);
+		void addSpellGroupCooldown(SpellGroup_t groupId, uint32_t ticks);
+		void sendSpellCooldowns();
 		void addDefaultRegeneration(uint32_t addTicks);
 
 		virtual uint64_t getGainedExperience(Creature* attacker) const;
@@ -539,7 +568,8 @@ class Player : public Creature, public Cylinder
 		void setSkull(Skulls_t newSkull) {skull = newSkull;}
 		void sendCreatureSkull(const Creature* creature) const
 			{if(client) client->sendCreatureSkull(creature);}
-		void checkSkullTicks(int32_t ticks);
+		void checkSkullTicks();
+		int64_t getSkullTicks() const {return std::max<int64_t>(0, skullEndTime - OTSYS_TIME());}
 
 		const OutfitListType& getPlayerOutfits();
 		bool canWear(uint32_t _looktype, uint32_t _addons);
@@ -676,7 +706,9 @@ class Player : public Creature, public Cylinder
 		void sendPing();
 		void sendPingBack() const
 			{if(client) client->sendPingBack();}
+		//stats requested during a task are sent once, in a task of their own
 		void sendStats();
+		void flushStats();
 		void sendBasicData() const
 			{if(client) client->sendBasicData();}
 		void sendSkills() const
@@ -783,6 +815,8 @@ class Player : public Creature, public Cylinder
 		void addExperience(uint64_t exp, bool useMult = false, bool sendText = false, bool applyStaminaChange = false);
 
 		void updateInventoryWeight();
+		void updateInventoryArmor();
+		int32_t sumInventoryArmor() const;
 		void postUpdateGoods(uint32_t itemId);
 
 		void setNextWalkActionTask(SchedulerTask* task);
@@ -875,6 +909,13 @@ class Player : public Creature, public Cylinder
 		double inventoryWeight;
 		double capacity;
 
+		//armor of the equipped items, refreshed whenever the inventory changes
+		int32_t inventoryArmor;
+
+		//end times of the spell and spell group cooldowns, 0 when never used
+		int64_t spellCooldowns[256];
+		int64_t spellGroupCooldowns[SPELLGROUP_LAST + 1];
+
 		int64_t lastPing;
 		int64_t lastPong;
 
@@ -942,6 +983,7 @@ class Player : public Creature, public Cylinder
 		uint64_t bankBalance;
 
 		uint16_t lastStatsTrainingTime;
+		bool statsPending;
 
 		Position lastWalkthroughPosition;
 		int64_t lastWalkthroughAttempt;
@@ -974,7 +1016,8 @@ class Player : public Creature, public Cylinder
 		House* editHouse;
 		uint32_t editListId;
 
-		int64_t skullTicks;
+		//time at which the last unjustified kill stops counting, 0 if there is none
+		int64_t skullEndTime;
 		Skulls_t skull;
 		typedef OTSERV_HASH_SET<uint32_t> AttackedSet;
 		AttackedSet attackedSet;
@@ -1021,6 +1064,7 @@ class Player : public Creature, public Cylinder
 	friend class Actions;
 	friend class IOLoginData;
 	friend class ProtocolGame;
+	friend class CombatBench;
 };
 
 #endif
@@ -61,6 +61,7 @@ Chat g_chat;
 
 #ifdef __ENABLE_SERVER_DIAGNOSTIC__
 uint32_t ProtocolGame::protocolGameCount = 0;
+uint64_t ProtocolGame::packetsWritten = 0;
 #endif
 
 // Helping templates to add dispatcher tasks
@@ -80,6 +81,10 @@ ProtocolGame::ProtocolGame(Connection_ptr connection) :
 	m_debugAssertSent = false;
 	m_acceptPackets = false;
 	eventConnect = 0;
+#ifdef __COMBAT_BENCH__
+	m_benchSink = false;
+	m_benchBufferSize = 0;
+#endif
 #ifdef __ENABLE_SERVER_DIAGNOSTIC__
 	protocolGameCount++;
 #endif
@@ -98,6 +103,15 @@ void ProtocolGame::setPlayer(Player* p)
 	player = p;
 }
 
+#ifdef __COMBAT_BENCH__
+ProtocolGame* ProtocolGame::createBenchProtocol()
+{
+	ProtocolGame* protocol = new ProtocolGame(Connection_ptr());
+	protocol->m_benchSink = true;
+	return protocol;
+}
+#endif
+
 void ProtocolGame::releaseProtocol()
 {
 	//dispatcher thread
@@ -538,9 +552,29 @@ void ProtocolGame::disconnect()
 
 void ProtocolGame::writeToOutputBuffer(const NetworkMessage& msg)
 {
+	#ifdef __COMBAT_BENCH__
+	if(m_benchSink)
+	{
+		//same copy as OutputMessage::append, the buffer is reused once it would overflow like a sent message
+		int32_t msgLen = msg.getMessageLength();
+		if(m_benchBufferSize + msgLen > NetworkMessage::max_body_length)
+			m_benchBufferSize = 0;
+
+		memcpy(m_benchBuffer + m_benchBufferSize, msg.getBuffer() + 8, msgLen);
+		m_benchBufferSize += msgLen;
+		packetsWritten++;
+		return;
+	}
+	#endif
+
 	OutputMessage_ptr out = getOutputBuffer(msg.getMessageLength());
 	if(out)
+	{
 		out->append(msg);
+		#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+		packetsWritten++;
+		#endif
+	}
 }
 
 void ProtocolGame::parsePacket(NetworkMessage& msg)
@@ -55,6 +55,7 @@ class ProtocolGame : public Protocol
 
 #ifdef __ENABLE_SERVER_DIAGNOSTIC__
 		static uint32_t protocolGameCount;
+		static uint64_t packetsWritten;
 #endif
 		ProtocolGame(Connection_ptr connection);
 		virtual ~ProtocolGame();
@@ -66,6 +67,11 @@ class ProtocolGame : public Protocol
 
 		void setPlayer(Player* p);
 
+#ifdef __COMBAT_BENCH__
+		//connectionless protocol for the combat benchmark, packets are built, copied and counted but never sent
+		static ProtocolGame* createBenchProtocol();
+#endif
+
 	private:
 		OTSERV_HASH_SET<uint32_t> knownCreatureSet;
 
@@ -349,6 +355,12 @@ class ProtocolGame : public Protocol
 
 		bool m_debugAssertSent;
 		bool m_acceptPackets;
+
+#ifdef __COMBAT_BENCH__
+		bool m_benchSink;
+		uint8_t m_benchBuffer[NETWORKMESSAGE_MAXSIZE];
+		int32_t m_benchBufferSize;
+#endif
 };
 
 #endif
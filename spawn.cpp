@@ -35,12 +35,22 @@ extern Game g_game;
 
 #define MINSPAWN_INTERVAL 1000
 #define DEFAULTSPAWN_INTERVAL 60000
+#define SPAWN_CHECK_INTERVAL 1000
+#define SPAWN_GRID_BITS 4
+
+static inline uint32_t getSpawnGridCell(int32_t x, int32_t y, int32_t z)
+{
+	return ((uint32_t)z << 24) | ((uint32_t)(x >> SPAWN_GRID_BITS) << 12) | (uint32_t)(y >> SPAWN_GRID_BITS);
+}
 
 Spawns::Spawns()
 {
 	loaded = false;
 	started = false;
 	filename = "";
+
+	checkSpawnEvent = 0;
+	playerGridValid = false;
 }
 
 Spawns::~Spawns()
@@ -253,6 +263,13 @@ void Spawns::startup()
 
 void Spawns::clear()
 {
+	if(checkSpawnEvent != 0)
+	{
+		g_scheduler.stopEvent(checkSpawnEvent);
+		checkSpawnEvent = 0;
+	}
+
+	checkSpawnSet.clear();
 	for(SpawnList::iterator it= spawnList.begin(); it != spawnList.end(); ++it)
 		delete (*it);
 
@@ -272,10 +289,100 @@ bool Spawns::isInZone(const Position& centerPos, int32_t radius, const Position&
 		(pos.y >= centerPos.y - radius) && (pos.y <= centerPos.y + radius));
 }
 
-void Spawn::startSpawnCheck()
+void Spawns::addSpawnCheck(Spawn* spawn)
 {
+	checkSpawnSet.insert(spawn);
 	if(checkSpawnEvent == 0)
-		checkSpawnEvent = g_scheduler.addEvent(createSchedulerTask(getInterval(), boost::bind(&Spawn::checkSpawn, this)));
+		checkSpawnEvent = g_scheduler.addEvent(createSchedulerTask(SPAWN_CHECK_INTERVAL, boost::bind(&Spawns::checkSpawns, this)));
+}
+
+void Spawns::removeSpawnCheck(Spawn* spawn)
+{
+	checkSpawnSet.erase(spawn);
+}
+
+void Spawns::checkSpawns()
+{
+	checkSpawnEvent = 0;
+	playerGridValid = false;
+
+	int64_t startTime = OTSYS_TIME();
+	uint32_t checked = 0;
+	for(SpawnSet::iterator it = checkSpawnSet.begin(); it != checkSpawnSet.end();)
+	{
+		Spawn* spawn = *it;
+		if(spawn->getNextCheck() > startTime)
+		{
+			++it;
+			continue;
+		}
+
+		++checked;
+		if(!spawn->checkSpawn())
+			checkSpawnSet.erase(it++);
+		else
+			++it;
+	}
+
+	uint32_t duration = (uint32_t)(OTSYS_TIME() - startTime);
+	++checkStats.ticks;
+	checkStats.lastChecked = checked;
+	checkStats.lastDuration = duration;
+	checkStats.maxDuration = std::max(checkStats.maxDuration, duration);
+#ifdef __DEBUG_SPAWN__
+	std::cout << "[Notice] Spawns::checkSpawns " << checked << " of " << checkSpawnSet.size() << " spawns in " << duration << " ms" << std::endl;
+#endif
+
+	if(!checkSpawnSet.empty())
+		checkSpawnEvent = g_scheduler.addEvent(createSchedulerTask(SPAWN_CHECK_INTERVAL, boost::bind(&Spawns::checkSpawns, this)));
+}
+
+void Spawns::updatePlayerGrid()
+{
+	playerGrid.clear();
+	for(AutoList<Player>::listiterator it = Player::listPlayer.list.begin(); it != Player::listPlayer.list.end(); ++it)
+	{
+		Player* player = it->second;
+		if(player->isRemoved() || player->hasFlag(PlayerFlag_IgnoredByMonsters))
+			continue;
+
+		//mark every cell a spawn block could be in while this player is on its spectator list
+		const Position& pos = player->getPosition();
+		int32_t startX = std::max<int32_t>(0, pos.x - Map::maxViewportX), endX = pos.x + Map::maxViewportX;
+		int32_t startY = std::max<int32_t>(0, pos.y - Map::maxViewportY), endY = pos.y + Map::maxViewportY;
+		for(int32_t y = startY >> SPAWN_GRID_BITS; y <= (endY >> SPAWN_GRID_BITS); ++y)
+		{
+			for(int32_t x = startX >> SPAWN_GRID_BITS; x <= (endX >> SPAWN_GRID_BITS); ++x)
+				playerGrid.insert(getSpawnGridCell(x << SPAWN_GRID_BITS, y << SPAWN_GRID_BITS, pos.z));
+		}
+	}
+
+	playerGridValid = true;
+}
+
+bool Spawns::isPlayerNearby(const Position& pos)
+{
+	if(!playerGridValid)
+		updatePlayerGrid();
+
+	if(playerGrid.find(getSpawnGridCell(pos.x, pos.y, pos.z)) == playerGrid.end())
+	{
+		++checkStats.gridSkips;
+		return false;
+	}
+
+	++checkStats.playerQueries;
+	return true;
+}
+
+void Spawn::startSpawnCheck()
+{
+	if(checking)
+		return;
+
+	checking = true;
+	nextCheck = OTSYS_TIME() + getInterval();
+	Spawns::getInstance()->addSpawnCheck(this);
 }
 
 Spawn::Spawn(const Position& _pos, int32_t _radius)
@@ -283,7 +390,8 @@ Spawn::Spawn(const Position& _pos, int32_t _radius)
 	centerPos = _pos;
 	radius = _radius;
 	interval = DEFAULTSPAWN_INTERVAL;
-	checkSpawnEvent = 0;
+	checking = false;
+	nextCheck = 0;
 }
 
 Spawn::~Spawn()
@@ -307,6 +415,9 @@ Spawn::~Spawn()
 
 bool Spawn::findPlayer(const Position& pos)
 {
+	if(!Spawns::getInstance()->isPlayerNearby(pos))
+		return false;
+
 	SpectatorVec list;
 	g_game.getSpectators(list, pos, false, true);
 	for(SpectatorVec::const_iterator it = list.begin(), end = list.end(); it != end; ++it)
@@ -367,12 +478,11 @@ void Spawn::startup()
 	}
 }
 
-void Spawn::checkSpawn()
+bool Spawn::checkSpawn()
 {
 #ifdef __DEBUG_SPAWN__
 	std::cout << "[Notice] Spawn::checkSpawn " << this << std::endl;
 #endif
-	checkSpawnEvent = 0;
 
 	cleanup();
 
@@ -403,11 +513,16 @@ void Spawn::checkSpawn()
 	}
 
 	if(spawnedMap.size() < spawnMap.size())
-		checkSpawnEvent = g_scheduler.addEvent(createSchedulerTask(getInterval(), boost::bind(&Spawn::checkSpawn, this)));
+	{
+		nextCheck = OTSYS_TIME() + getInterval();
+		return true;
+	}
+
 #ifdef __DEBUG_SPAWN__
-	else
-		std::cout << "[Notice] Spawn::checkSpawn stopped " << this << std::endl;
+	std::cout << "[Notice] Spawn::checkSpawn stopped " << this << std::endl;
 #endif
+	checking = false;
+	return false;
 }
 
 void Spawn::cleanup()
@@ -476,9 +591,9 @@ void Spawn::removeMonster(Monster* monster)
 
 void Spawn::stopEvent()
 {
-	if(checkSpawnEvent != 0)
+	if(checking)
 	{
-		g_scheduler.stopEvent(checkSpawnEvent);
-		checkSpawnEvent = 0;
+		Spawns::getInstance()->removeSpawnCheck(this);
+		checking = false;
 	}
 }
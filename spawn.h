@@ -29,10 +29,24 @@
 
 #include <vector>
 #include <map>
+#include <set>
 
 class Spawn;
 typedef std::list<Spawn*> SpawnList;
 
+struct SpawnCheckStats
+{
+	SpawnCheckStats() : ticks(0), lastChecked(0), lastDuration(0), maxDuration(0),
+		gridSkips(0), playerQueries(0) {}
+
+	uint64_t ticks;
+	uint32_t lastChecked;
+	uint32_t lastDuration;
+	uint32_t maxDuration;
+	uint64_t gridSkips;
+	uint64_t playerQueries;
+};
+
 class Spawns
 {
 	private:
@@ -56,12 +70,31 @@ class Spawns
 		bool isLoaded() const {return loaded;}
 		bool isStarted() const {return started;}
 
+		//all spawns waiting for a respawn are checked together in one tick
+		void addSpawnCheck(Spawn* spawn);
+		void removeSpawnCheck(Spawn* spawn);
+
+		bool isPlayerNearby(const Position& pos);
+		const SpawnCheckStats& getCheckStats() const {return checkStats;}
+
 	private:
+		void checkSpawns();
+		void updatePlayerGrid();
+
 		typedef std::list<Npc*> NpcList;
 		NpcList npcList;
 		SpawnList spawnList;
 		bool loaded, started;
 		std::string filename;
+
+		typedef std::set<Spawn*> SpawnSet;
+		SpawnSet checkSpawnSet;
+		uint32_t checkSpawnEvent;
+		SpawnCheckStats checkStats;
+
+		//coarse cells that have a player within viewport range, rebuilt once per tick
+		std::set<uint32_t> playerGrid;
+		bool playerGridValid;
 };
 
 struct spawnBlock_t
@@ -88,6 +121,9 @@ class Spawn
 		void startSpawnCheck();
 		void stopEvent();
 
+		int64_t getNextCheck() const {return nextCheck;}
+		bool checkSpawn();
+
 		bool isInSpawnZone(const Position& pos);
 		void cleanup();
 
@@ -107,11 +143,11 @@ class Spawn
 		SpawnedMap spawnedMap;
 
 		uint32_t interval;
-		uint32_t checkSpawnEvent;
+		bool checking;
+		int64_t nextCheck;
 
 		bool findPlayer(const Position& pos);
 		bool spawnMonster(uint32_t spawnId, MonsterType* mType, const Position& pos, Direction dir, bool startup = false);
-		void checkSpawn();
 };
 
 #endif
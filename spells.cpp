@@ -29,6 +29,7 @@
 #include "monsters.h"
 #include "configmanager.h"
 #include "const.h"
+#include "combatlog.h"
 
 #include <libxml/xmlmemory.h>
 #include <libxml/parser.h>
@@ -42,6 +43,7 @@ extern ConfigManager g_config;
 Spells::Spells():
 m_scriptInterface("Spell Interface")
 {
+	instantNodesValid = false;
 	m_scriptInterface.initState();
 }
 
@@ -124,6 +126,8 @@ void Spells::clear()
 		delete it2->second;
 
 	instants.clear();
+	instantNodes.clear();
+	instantNodesValid = false;
 }
 
 LuaScriptInterface& Spells::getScriptInterface()
@@ -162,6 +166,7 @@ bool Spells::registerEvent(Event* event, xmlNodePtr p)
 		}
 
 		instants[instant->getWords()] = instant;
+		instantNodesValid = false;
 		return true;
 	}
 	else if(rune)
@@ -209,7 +214,77 @@ RuneSpell* Spells::getRuneSpellByName(const std::string& name)
 	return NULL;
 }
 
+void Spells::updateInstantNodes()
+{
+	instantNodes.clear();
+	instantNodes.push_back(InstantNode());
+	for(InstantsMap::iterator it = instants.begin(); it != instants.end(); ++it)
+	{
+		const std::string& instantSpellWords = it->second->getWords();
+
+		uint32_t node = 0;
+		for(size_t i = 0; i < instantSpellWords.length(); ++i)
+		{
+			char c = (char)tolower((unsigned char)instantSpellWords[i]);
+			std::map<char, uint32_t>::const_iterator cit = instantNodes[node].children.find(c);
+			if(cit != instantNodes[node].children.end())
+				node = cit->second;
+			else
+			{
+				uint32_t child = instantNodes.size();
+				instantNodes[node].children[c] = child;
+				instantNodes.push_back(InstantNode());
+				node = child;
+			}
+		}
+
+		//words differing only in case share a node, the first in map order wins like before
+		if(!instantNodes[node].spell)
+			instantNodes[node].spell = it->second;
+	}
+
+	instantNodesValid = true;
+}
+
 InstantSpell* Spells::getInstantSpell(const std::string& words)
+{
+	if(!instantNodesValid)
+		updateInstantNodes();
+
+	//the deepest spell on the path is the longest case insensitive prefix of words
+	uint32_t node = 0;
+	InstantSpell* result = instantNodes[node].spell;
+	for(size_t i = 0; i < words.length(); ++i)
+	{
+		std::map<char, uint32_t>::const_iterator it = instantNodes[node].children.find((char)tolower((unsigned char)words[i]));
+		if(it == instantNodes[node].children.end())
+			break;
+
+		node = it->second;
+		if(instantNodes[node].spell)
+			result = instantNodes[node].spell;
+	}
+
+	if(result)
+	{
+		const std::string& resultWords = result->getWords();
+		if(words.length() > resultWords.length())
+		{
+			if(!result->getHasParam())
+				return NULL;
+
+			size_t spellLen = resultWords.length();
+			size_t paramLen = words.length() - spellLen;
+			if(paramLen < 2 || words[spellLen] != ' ')
+				return NULL;
+		}
+		return result;
+	}
+	return NULL;
+}
+
+#if defined(__DEBUG__) || defined(__COMBAT_BENCH__)
+InstantSpell* Spells::getInstantSpellSlow(const std::string& words)
 {
 	InstantSpell* result = NULL;
 	for(InstantsMap::iterator it = instants.begin(); it != instants.end(); ++it)
@@ -242,6 +317,7 @@ InstantSpell* Spells::getInstantSpell(const std::string& words)
 	}
 	return NULL;
 }
+#endif
 
 uint32_t Spells::getInstantSpellCount(const Player* player)
 {
@@ -414,6 +490,7 @@ bool CombatSpell::executeCastSpell(Creature* creature, const LuaVariant& var)
 Spell::Spell()
 {
 	spellId = 0;
+	combatLogSource = NULL;
 	level = 0;
 	magLevel = 0;
 	mana = 0;
@@ -688,7 +765,7 @@ bool Spell::playerSpellCheck(Player* player, bool ignoreExhaust/* = false*/) con
 		return false;
 	}
 
-	if(player->hasCondition(CONDITION_SPELLGROUPCOOLDOWN, group) || player->hasCondition(CONDITION_SPELLCOOLDOWN, spellId))
+	if(player->hasSpellGroupCooldown(group) || player->hasSpellCooldown(spellId))
 	{
 		player->sendCancelMessage(RET_YOUAREEXHAUSTED);
 		if(isInstant())
@@ -911,22 +988,13 @@ void Spell::postCastSpell(Player* player, bool finishedCast /*= true*/, bool pay
 		if(!player->hasFlag(PlayerFlag_HasNoExhaustion))
 		{
 			if(cooldown > 0)
-			{
-				Condition* condition = Condition::createCondition(CONDITIONID_DEFAULT, CONDITION_SPELLCOOLDOWN, cooldown, 0, false, spellId);
-				player->addCondition(condition);
-			}
+				player->addSpellCooldown(spellId, cooldown);
 
 			if(groupCooldown > 0)
-			{
-				Condition* condition = Condition::createCondition(CONDITIONID_DEFAULT, CONDITION_SPELLGROUPCOOLDOWN, groupCooldown, 0, false, group);
-				player->addCondition(condition);
-			}
+				player->addSpellGroupCooldown(group, groupCooldown);
 
 			if(secondaryGroupCooldown > 0)
-			{
-				Condition* condition = Condition::createCondition(CONDITIONID_DEFAULT, CONDITION_SPELLGROUPCOOLDOWN, secondaryGroupCooldown, 0, false, secondaryGroup);
-				player->addCondition(condition);
-			}
+				player->addSpellGroupCooldown(secondaryGroup, secondaryGroupCooldown);
 		}
 
 		if(!player->hasFlag(PlayerFlag_NotGainInFight))
@@ -1280,6 +1348,7 @@ bool InstantSpell::castSpell(Creature* creature, Creature* target)
 
 bool InstantSpell::internalCastSpell(Creature* creature, const LuaVariant& var)
 {
+	CombatLogScope logScope(combatLogSource, getName());
 	bool result = false;
 
 	if(m_scripted)
@@ -2227,6 +2296,7 @@ bool RuneSpell::castSpell(Creature* creature, Creature* target)
 
 bool RuneSpell::internalCastSpell(Creature* creature, const LuaVariant& var)
 {
+	CombatLogScope logScope(combatLogSource, getName());
 	bool result = false;
 
 	if(m_scripted)
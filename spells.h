@@ -32,6 +32,7 @@ class InstantSpell;
 class ConjureSpell;
 class RuneSpell;
 class Spell;
+struct CombatLogSource;
 
 typedef std::map<uint32_t, RuneSpell*> RunesMap;
 typedef std::map<std::string, InstantSpell*> InstantsMap;
@@ -47,6 +48,10 @@ class Spells : public BaseEvents
 		RuneSpell* getRuneSpellByName(const std::string& name);
 
 		InstantSpell* getInstantSpell(const std::string& words);
+#if defined(__DEBUG__) || defined(__COMBAT_BENCH__)
+		//the scan over every instant spell from before the trie, only kept as the reference for getInstantSpell
+		InstantSpell* getInstantSpellSlow(const std::string& words);
+#endif
 		InstantSpell* getInstantSpellByName(const std::string& name);
 
 		uint32_t getInstantSpellCount(const Player* player);
@@ -66,6 +71,19 @@ class Spells : public BaseEvents
 		RunesMap runes;
 		InstantsMap instants;
 
+		//case folded trie over the instant spell words, rebuilt after the spells change
+		struct InstantNode
+		{
+			InstantNode() : spell(NULL) {}
+
+			std::map<char, uint32_t> children;
+			InstantSpell* spell;
+		};
+
+		void updateInstantNodes();
+		std::vector<InstantNode> instantNodes;
+		bool instantNodesValid;
+
 		friend class CombatSpell;
 		LuaScriptInterface m_scriptInterface;
 };
@@ -167,6 +185,8 @@ class Spell : public BaseSpell
 		typedef std::map<int32_t, bool> VocSpellMap;
 		VocSpellMap vocSpellMap;
 
+		CombatLogSource* combatLogSource;
+
 	private:
 		std::string name;
 };
@@ -50,6 +50,8 @@ void TalkActions::clear()
 		wordsMap.erase(it);
 		it = wordsMap.begin();
 	}
+
+	wordsIndex.clear();
 	m_scriptInterface.reInitState();
 }
 
@@ -78,6 +80,7 @@ bool TalkActions::registerEvent(Event* event, xmlNodePtr p)
 		return false;
 
 	wordsMap.push_back(std::make_pair(talkAction->getWords(), talkAction));
+	wordsIndex.insert(std::make_pair(talkAction->getWords(), talkAction));
 	return true;
 }
 
@@ -103,21 +106,37 @@ TalkActionResult_t TalkActions::playerSaySpell(Player* player, SpeakClasses type
 	trim_left(str_words, " ");
 	trim_right(str_words, " ");
 
-	TalkActionList::iterator it;
-	for(it = wordsMap.begin(); it != wordsMap.end(); ++it)
+	TalkAction* talkAction = getTalkAction(str_words);
+	if(!talkAction)
+		return TALKACTION_CONTINUE;
+
+	int32_t ret = talkAction->executeSay(player, str_words, str_param);
+	if(ret == 1)
+		return TALKACTION_CONTINUE;
+	else
+		return TALKACTION_BREAK;
+}
+
+TalkAction* TalkActions::getTalkAction(const std::string& words) const
+{
+	TalkActionIndex::const_iterator it = wordsIndex.find(words);
+	if(it == wordsIndex.end())
+		return NULL;
+
+	return it->second;
+}
+
+#if defined(__DEBUG__) || defined(__COMBAT_BENCH__)
+TalkAction* TalkActions::getTalkActionSlow(const std::string& words) const
+{
+	for(TalkActionList::const_iterator it = wordsMap.begin(); it != wordsMap.end(); ++it)
 	{
-		if(it->first == str_words)
-		{
-			TalkAction* talkAction = it->second;
-			int32_t ret = talkAction->executeSay(player, str_words, str_param);
-			if(ret == 1)
-				return TALKACTION_CONTINUE;
-			else
-				return TALKACTION_BREAK;
-		}
+		if(it->first == words)
+			return it->second;
 	}
-	return TALKACTION_CONTINUE;
+	return NULL;
 }
+#endif
 
 TalkAction::TalkAction(LuaScriptInterface* _interface) :
 Event(_interface)
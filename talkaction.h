@@ -45,6 +45,13 @@ class TalkActions : public BaseEvents
 
 		TalkActionResult_t playerSaySpell(Player* player, SpeakClasses type, const std::string& words);
 
+		//words without the param and the surrounding spaces
+		TalkAction* getTalkAction(const std::string& words) const;
+#if defined(__DEBUG__) || defined(__COMBAT_BENCH__)
+		//the scan over the list from before the index, only kept as the reference for getTalkAction
+		TalkAction* getTalkActionSlow(const std::string& words) const;
+#endif
+
 	protected:
 		virtual LuaScriptInterface& getScriptInterface();
 		virtual std::string getScriptBaseName();
@@ -55,6 +62,10 @@ class TalkActions : public BaseEvents
 		typedef std::list< std::pair<std::string, TalkAction* > > TalkActionList;
 		TalkActionList wordsMap;
 
+		//words to the first talkaction registered with them
+		typedef std::map<std::string, TalkAction*> TalkActionIndex;
+		TalkActionIndex wordsIndex;
+
 		LuaScriptInterface m_scriptInterface;
 };
 
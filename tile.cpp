@@ -40,10 +40,41 @@ extern Game g_game;
 extern MoveEvents* g_moveEvents;
 
 StaticTile real_null_tile(0xFFFF, 0xFFFF, 0xFFFF);
+#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+uint32_t StaticTile::vectorCount = 0;
+#endif
 Tile& Tile::null_tile = real_null_tile;
 
 bool Tile::hasProperty(enum ITEMPROPERTY prop) const
 {
+	//properties mirrored in the tile flags by updateTileFlags don't need a scan
+	switch(prop)
+	{
+		case BLOCKSOLID:
+			return hasFlag(TILESTATE_BLOCKSOLID);
+
+		case BLOCKPROJECTILE:
+			return hasFlag(TILESTATE_BLOCKPROJECTILE);
+
+		case BLOCKPATH:
+			return hasFlag(TILESTATE_BLOCKPATH);
+
+		case IMMOVABLEBLOCKSOLID:
+			return hasFlag(TILESTATE_IMMOVABLEBLOCKSOLID);
+
+		case IMMOVABLEBLOCKPATH:
+			return hasFlag(TILESTATE_IMMOVABLEBLOCKPATH);
+
+		case IMMOVABLENOFIELDBLOCKPATH:
+			return hasFlag(TILESTATE_IMMOVABLENOFIELDBLOCKPATH);
+
+		case NOFIELDBLOCKPATH:
+			return hasFlag(TILESTATE_NOFIELDBLOCKPATH);
+
+		default:
+			break;
+	}
+
 	if(ground && ground->hasProperty(prop))
 		return true;
 
@@ -710,36 +741,17 @@ ReturnValue Tile::__queryAdd(int32_t index, const Thing* thing, uint32_t count,
 			}
 		}
 
-		if(items)
+		//the flags cover the ground too, a StaticTile may have no item list at all
+		if(!hasBitSet(FLAG_IGNOREBLOCKITEM, flags))
 		{
-			if(!hasBitSet(FLAG_IGNOREBLOCKITEM, flags))
-			{
-				//If the FLAG_IGNOREBLOCKITEM bit isn't set we dont have to iterate every single item
-				if(hasFlag(TILESTATE_BLOCKSOLID))
-					return RET_NOTENOUGHROOM;
-			}
-			else
-			{
-				//FLAG_IGNOREBLOCKITEM is set
-				if(ground)
-				{
-					const ItemType& iiType = Item::items[ground->getID()];
-					if(iiType.blockSolid && (!iiType.moveable || ground->getUniqueId() != 0))
-						return RET_NOTPOSSIBLE;
-				}
-
-				if(const TileItemVector* items = getItemList())
-				{
-					Item* iitem;
-					for(ItemVector::const_iterator it = items->begin(); it != items->end(); ++it)
-					{
-						iitem = (*it);
-						const ItemType& iiType = Item::items[iitem->getID()];
-						if(iiType.blockSolid && (!iiType.moveable || iitem->getUniqueId() != 0))
-							return RET_NOTPOSSIBLE;
-					}
-				}
-			}
+			//If the FLAG_IGNOREBLOCKITEM bit isn't set we dont have to iterate every single item
+			if(hasFlag(TILESTATE_BLOCKSOLID))
+				return RET_NOTENOUGHROOM;
+		}
+		else if(hasFlag(TILESTATE_IMMOVABLEBLOCKSOLID))
+		{
+			//FLAG_IGNOREBLOCKITEM is set, only immovable items still block
+			return RET_NOTPOSSIBLE;
 		}
 	}
 	else if(const Item* item = thing->getItem())
@@ -816,7 +828,7 @@ ReturnValue Tile::__queryAdd(int32_t index, const Thing* thing, uint32_t count,
 				if(hasHangable && supportHangable)
 					return RET_NEEDEXCHANGE;
 			}
-			else
+			else if(hasFlag(TILESTATE_BLOCKSOLID))
 			{
 				for(ItemVector::const_iterator it = items->begin(), end = items->end(); it != end; ++it)
 				{
@@ -1337,6 +1349,9 @@ void Tile::__removeThing(Thing* thing, uint32_t count)
 						(*it)->setParent(NULL);
 						items->erase(it);
 						--thingCount;
+						if(items->empty() && !is_dynamic())
+							g_game.FreeTileItemList(this);
+
 						onRemoveTileItem(list, oldStackPosVector, item);
 						return;
 					}
@@ -1378,6 +1393,9 @@ void Tile::__removeThing(Thing* thing, uint32_t count)
 							items->erase(it);
 							--items->downItemCount;
 							--thingCount;
+							if(items->empty() && !is_dynamic())
+								g_game.FreeTileItemList(this);
+
 							onRemoveTileItem(list, oldStackPosVector, item);
 						}
 						return;
@@ -1672,7 +1690,7 @@ void Tile::__internalAddThing(uint32_t index, Thing* thing)
 		if(item == NULL)
 			return;
 
-		TileItemVector* items = makeItemList();
+		TileItemVector* items = getItemList();
 		if(items && items->size() >= 0xFFFF)
 			return /*RET_NOTPOSSIBLE*/;
 
@@ -1686,6 +1704,8 @@ void Tile::__internalAddThing(uint32_t index, Thing* thing)
 		}
 		else if(item->isAlwaysOnTop())
 		{
+			//ground alone must not allocate the item list of a StaticTile
+			items = makeItemList();
 			bool isInserted = false;
 			for(ItemVector::iterator it = items->getBeginTopItem(); it != items->getEndTopItem(); ++it)
 			{
@@ -1706,6 +1726,7 @@ void Tile::__internalAddThing(uint32_t index, Thing* thing)
 		}
 		else
 		{
+			items = makeItemList();
 			items->insert(items->getBeginDownItem(), item);
 			++items->downItemCount;
 			++thingCount;
@@ -1771,6 +1792,9 @@ void Tile::updateTileFlags(Item* item, bool removing)
 		if(item->hasProperty(BLOCKPATH))
 			setFlag(TILESTATE_BLOCKPATH);
 
+		if(item->hasProperty(IMMOVABLEBLOCKPATH))
+			setFlag(TILESTATE_IMMOVABLEBLOCKPATH);
+
 		if(item->hasProperty(NOFIELDBLOCKPATH))
 			setFlag(TILESTATE_NOFIELDBLOCKPATH);
 
@@ -1792,6 +1816,9 @@ void Tile::updateTileFlags(Item* item, bool removing)
 		if(item->hasProperty(BLOCKSOLID))
 			setFlag(TILESTATE_BLOCKSOLID);
 
+		if(item->hasProperty(BLOCKPROJECTILE))
+			setFlag(TILESTATE_BLOCKPROJECTILE);
+
 		if(item->getBed())
 			setFlag(TILESTATE_BED);
 
@@ -1845,6 +1872,9 @@ void Tile::updateTileFlags(Item* item, bool removing)
 		if(item->hasProperty(BLOCKSOLID) && !hasProperty(item, BLOCKSOLID))
 			resetFlag(TILESTATE_BLOCKSOLID);
 
+		if(item->hasProperty(BLOCKPROJECTILE) && !hasProperty(item, BLOCKPROJECTILE))
+			resetFlag(TILESTATE_BLOCKPROJECTILE);
+
 		if(item->hasProperty(IMMOVABLEBLOCKSOLID) && !hasProperty(item, IMMOVABLEBLOCKSOLID))
 			resetFlag(TILESTATE_IMMOVABLEBLOCKSOLID);
 
@@ -1878,6 +1908,13 @@ void Tile::updateTileFlags(Item* item, bool removing)
 		if(item->getContainer() && item->getContainer()->getDepotLocker())
 			resetFlag(TILESTATE_DEPOT);
 	}
+
+	//keep the sight line bitmap of the floor in sync
+	if(qt_node)
+	{
+		if(Floor* floor = qt_node->getFloor(tilePos.z))
+			floor->setBlockingProjectile(tilePos.x, tilePos.y, hasFlag(TILESTATE_BLOCKPROJECTILE));
+	}
 }
 
 bool Tile::isMoveableBlocking() const
@@ -73,7 +73,8 @@ enum tileflags_t
 	TILESTATE_NOFIELDBLOCKPATH = 16777216,
 	TILESTATE_DYNAMIC_TILE = 33554432,
 	TILESTATE_FLOORCHANGE_SOUTH_ALT = 67108864,
-	TILESTATE_FLOORCHANGE_EAST_ALT = 134217728
+	TILESTATE_FLOORCHANGE_EAST_ALT = 134217728,
+	TILESTATE_BLOCKPROJECTILE = 268435456
 };
 
 enum ZoneType_t
@@ -103,6 +104,7 @@ class TileItemVector
 
 		size_t size() {return items.size();}
 		size_t size() const {return items.size();}
+		bool empty() const {return items.empty();}
 
 		ItemVector::iterator insert(ItemVector::iterator _where, Item* item) {return items.insert(_where, item);}
 		ItemVector::iterator erase(ItemVector::iterator _pos) {return items.erase(_pos);}
@@ -289,8 +291,8 @@ class Tile : public Cylinder
 		uint32_t m_flags;
 };
 
-// Used for walkable tiles, where there is high likeliness of
-// items being added/removed
+// Used for walkable tiles with items on them, where there is high
+// likeliness of items being added/removed
 class DynamicTile : public Tile
 {
 	// By allocating the vectors in-house, we avoid some memory fragmentation
@@ -310,7 +312,7 @@ class DynamicTile : public Tile
 		CreatureVector* makeCreatures() {return &creatures;}
 };
 
-// For blocking tiles, where we very rarely actually have items
+// For blocking tiles and plain ground tiles, where we very rarely actually have items
 class StaticTile : public Tile
 {
 	// We very rarely even need the vectors, so don't keep them in memory
@@ -321,13 +323,21 @@ class StaticTile : public Tile
 		StaticTile(uint16_t x, uint16_t y, uint16_t z);
 		~StaticTile();
 
+#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+		static uint32_t vectorCount;
+#endif
+
 		TileItemVector* getItemList() {return items;}
 		const TileItemVector* getItemList() const {return items;}
-		TileItemVector* makeItemList() {return (items)? (items) : (items = new TileItemVector);}
+		TileItemVector* makeItemList();
 
 		CreatureVector* getCreatures() {return creatures;}
 		const CreatureVector* getCreatures() const {return creatures;}
-		CreatureVector* makeCreatures() {return (creatures)? (creatures) : (creatures = new CreatureVector);}
+		CreatureVector* makeCreatures();
+
+		// Called from Game::cleanup, callers may still hold the list while removing items.
+		// The creature vector is kept once allocated, creatures step on and off far too often
+		void releaseEmptyItemList();
 };
 
 inline Tile::Tile(uint16_t x, uint16_t y, uint16_t z) :
@@ -402,6 +412,46 @@ inline StaticTile::StaticTile(uint16_t x, uint16_t y, uint16_t z) :
 
 inline StaticTile::~StaticTile()
 {
+	delete items;
+	delete creatures;
+}
+
+inline TileItemVector* StaticTile::makeItemList()
+{
+	if(!items)
+	{
+		items = new TileItemVector;
+#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+		++vectorCount;
+#endif
+	}
+
+	return items;
+}
+
+inline CreatureVector* StaticTile::makeCreatures()
+{
+	if(!creatures)
+	{
+		creatures = new CreatureVector;
+#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+		++vectorCount;
+#endif
+	}
+
+	return creatures;
+}
+
+inline void StaticTile::releaseEmptyItemList()
+{
+	if(items && items->empty())
+	{
+		delete items;
+		items = NULL;
+#ifdef __ENABLE_SERVER_DIAGNOSTIC__
+		--vectorCount;
+#endif
+	}
 }
 
 inline DynamicTile::DynamicTile(uint16_t x, uint16_t y, uint16_t z) :
@@ -46,21 +46,24 @@ Weapons::~Weapons()
 
 const Weapon* Weapons::getWeapon(const Item* item) const
 {
-	if(!item)
+	if(!item || item->getID() >= weapons.size())
 		return NULL;
 
-	WeaponMap::const_iterator it = weapons.find(item->getID());
-	if(it != weapons.end())
-		return it->second;
+	return weapons[item->getID()];
+}
 
-	return NULL;
+void Weapons::setWeapon(uint32_t id, Weapon* weapon)
+{
+	if(id >= weapons.size())
+		weapons.resize(id + 1, NULL);
+
+	weapons[id] = weapon;
 }
 
 void Weapons::clear()
 {
-	WeaponMap::iterator it;
-	for(it = weapons.begin(); it != weapons.end(); ++it)
-		delete it->second;
+	for(WeaponTable::iterator it = weapons.begin(); it != weapons.end(); ++it)
+		delete *it;
 
 	weapons.clear();
 }
@@ -81,7 +84,7 @@ bool Weapons::loadDefaults()
 	{
 		const ItemType* it = Item::items.getElement(i);
 
-		if(!it || weapons.find(it->id) != weapons.end())
+		if(!it || hasWeapon(it->id))
 			continue;
 
 		if(it->weaponType != WEAPON_NONE)
@@ -94,7 +97,7 @@ bool Weapons::loadDefaults()
 				{
 					WeaponMelee* weapon = new WeaponMelee(&m_scriptInterface);
 					weapon->configureWeapon(*it);
-					weapons[it->id] = weapon;
+					setWeapon(it->id, weapon);
 					break;
 				}
 
@@ -106,7 +109,7 @@ bool Weapons::loadDefaults()
 
 					WeaponDistance* weapon = new WeaponDistance(&m_scriptInterface);
 					weapon->configureWeapon(*it);
-					weapons[it->id] = weapon;
+					setWeapon(it->id, weapon);
 					break;
 				}
 				default:
@@ -136,13 +139,13 @@ bool Weapons::registerEvent(Event* event, xmlNodePtr p)
 	Weapon* weapon = dynamic_cast<Weapon*>(event);
 	if(weapon)
 	{
-		if(weapons.find(weapon->getID()) != weapons.end())
+		if(hasWeapon(weapon->getID()))
 		{
 			std::cout << "[Warning - Weapons::registerEvent] Duplicate registered item with id: " << weapon->getID() << std::endl;
 			return false;
 		}
 
-		weapons[weapon->getID()] = weapon;
+		setWeapon(weapon->getID(), weapon);
 		return true;
 	}
 	return false;
@@ -176,6 +179,7 @@ Weapon::Weapon(LuaScriptInterface* _interface) :
 	wieldUnproperly = false;
 	range = 1;
 	ammoAction = AMMOACTION_NONE;
+	combatLogSource = NULL;
 }
 
 Weapon::~Weapon()
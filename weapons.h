@@ -32,6 +32,7 @@
 #include "const.h"
 
 class Weapon;
+struct CombatLogSource;
 class WeaponMelee;
 class WeaponDistance;
 class WeaponWand;
@@ -55,8 +56,12 @@ class Weapons : public BaseEvents
 		virtual Event* getEvent(const std::string& nodeName);
 		virtual bool registerEvent(Event* event, xmlNodePtr p);
 
-		typedef std::map<uint32_t, Weapon*> WeaponMap;
-		WeaponMap weapons;
+		bool hasWeapon(uint32_t id) const {return id < weapons.size() && weapons[id];}
+		void setWeapon(uint32_t id, Weapon* weapon);
+
+		//indexed by item id, NULL for items that are no weapon
+		typedef std::vector<Weapon*> WeaponTable;
+		WeaponTable weapons;
 
 		LuaScriptInterface m_scriptInterface;
 };
@@ -87,6 +92,9 @@ class Weapon : public Event
 		bool isPremium() const {return premium;}
 		bool isWieldedUnproperly() const {return wieldUnproperly;}
 
+		//one weapon per item id, so the item name is the source, set on the first swing
+		mutable CombatLogSource* combatLogSource;
+
 	protected:
 		virtual std::string getScriptEventName();
 